@@ -0,0 +1,464 @@
+// 창과 GPU 없이 공 시뮬레이션만 돌려 성능을 재는 벤치마크 드라이버
+// 예) HeadlessBench --balls 20000 --steps 600 --seed 7 --threads 8 --broadphase sap --radius-scale 0.02
+// 스윕) HeadlessBench --sweep-restitution 0.2,0.4,0.6,0.8 --sweep-wall 0.5,0.8 --sweep-seeds 8
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <chrono>
+#include <vector>
+
+#include "../Physics/BallSimulation.h"
+#include "../Physics/BatchSimulation.h"
+
+struct FBenchOptions
+{
+    int NumBalls = 10000;
+    int NumSteps = 300;
+    int NumWarmupSteps = 60;   // 시간을 재기 전에 돌리는 스텝 (처음 퍼지는 구간 제외)
+    unsigned Seed = 1;
+    int Threads = 0;           // 0이면 모든 코어
+    bool Gravity = true;
+    bool Enable3D = false;
+    bool Ccd = true;
+    bool Sleeping = true;
+    bool Deterministic = false;
+    int CollisionPasses = 2;
+    bool AdaptiveSubsteps = false;
+    int MaxSubsteps = 8;
+    int ReorderInterval = 60;
+    int BroadPhase = BroadPhase_SpatialHash;
+    int Solver = Solver_Impulse;
+    int XpbdIterations = 4;
+    int XpbdSubsteps = 4;
+    int ObstacleLayout = ObstacleLayout_None;
+    int ContainerShape = Container_Box;
+    const char* ContainerMaskPath = nullptr; // 주어지면 이 PGM 그림을 용기로 쓴다
+    float StepTime = 1.0f / 60.0f;
+    float RadiusScale = 0.03f; // 앱의 기본 반지름은 만 개 단위로 띄우기엔 너무 크다
+
+    // 매개변수 스윕: 목록이 하나라도 주어지면 조합마다 월드 하나씩 만들어 한 프로세스에서 같이 돌린다
+    std::vector<float> SweepRestitution;
+    std::vector<float> SweepWallRestitution;
+    std::vector<float> SweepGravity; // 중력 가속도 (0이면 중력 끔)
+    std::vector<float> SweepBalls;
+    std::vector<int> SweepSolvers;
+    std::vector<float> SweepPasses;
+    int SweepSeeds = 0;              // 조합마다 seed를 Seed부터 이만큼 바꿔 돌린다
+
+    // 마지막 스텝의 평균 속력이 이보다 큰 월드가 있으면 종료 코드 2 (쌓인 더미가 가라앉는지 확인용, 0 이하면 검사 안 함)
+    float MaxMeanSpeed = 0.0f;
+
+    bool IsSweep() const
+    {
+        return !SweepRestitution.empty() || !SweepWallRestitution.empty() || !SweepGravity.empty() ||
+               !SweepBalls.empty() || !SweepSolvers.empty() || !SweepPasses.empty() || SweepSeeds > 0;
+    }
+};
+
+static void PrintUsage(const char* program)
+{
+    printf("usage: %s [options]\n", program);
+    printf("  --balls N          number of balls (default 10000)\n");
+    printf("  --steps M          timed steps (default 300)\n");
+    printf("  --warmup K         untimed steps before timing (default 60)\n");
+    printf("  --seed S           random seed for spawning (default 1)\n");
+    printf("  --threads T        worker threads including main, 0 = all cores (default 0)\n");
+    printf("  --broadphase B     hash | sap | brute (default hash)\n");
+    printf("  --obstacles L      none | pegs | funnel (default none)\n");
+    printf("  --container C      box | circle | star | mask (default box)\n");
+    printf("  --container-mask F binary PGM image used as the container (bright = free)\n");
+    printf("  --solver S         impulse | xpbd | xpbd-jacobi (default impulse)\n");
+    printf("  --xpbd-iterations N  position iterations per XPBD substep (default 4)\n");
+    printf("  --xpbd-substeps N  minimum substeps per XPBD step (default 4)\n");
+    printf("  --passes P         collision passes per step (default 2)\n");
+    printf("  --adaptive         pick substeps per step from max speed / min radius (one pass each)\n");
+    printf("  --max-substeps N   upper bound for --adaptive (default 8)\n");
+    printf("  --reorder N        Morton reorder every N steps, 0 = off (default 60)\n");
+    printf("  --dt SECONDS       step time (default 1/60)\n");
+    printf("  --radius-scale R   multiply spawn radii (default 0.03)\n");
+    printf("  --no-gravity       disable gravity\n");
+    printf("  --3d               spawn and simulate in the full 3D box\n");
+    printf("  --no-ccd           disable continuous collision\n");
+    printf("  --no-sleep         disable sleeping\n");
+    printf("  --deterministic    split parallel work independently of thread count\n");
+    printf("sweep (one world per combination, worlds spread across threads):\n");
+    printf("  --sweep-restitution LIST   ball restitution values, e.g. 0.2,0.4,0.6\n");
+    printf("  --sweep-wall LIST          wall restitution values, e.g. 0.5,0.8\n");
+    printf("  --sweep-gravity LIST       gravity accelerations, 0 = off, e.g. 0,-4.9,-9.8\n");
+    printf("  --sweep-balls LIST         ball counts, e.g. 1000,5000\n");
+    printf("  --sweep-solver LIST        solvers, e.g. impulse,xpbd,xpbd-jacobi\n");
+    printf("  --sweep-passes LIST        collision passes per step, e.g. 1,2,4,8\n");
+    printf("  --sweep-seeds N            run every combination with seeds S .. S+N-1\n");
+    printf("check:\n");
+    printf("  --max-mean-speed V         exit 2 if any world ends with a mean ball speed above V\n");
+}
+
+// 쉼표로 구분한 숫자 목록
+static bool ParseList(const char* text, std::vector<float>& outValues)
+{
+    outValues.clear();
+    while (*text)
+    {
+        char* end = nullptr;
+        outValues.push_back(strtof(text, &end));
+        if (end == text) return false;
+        if (*end == ',') end++;
+        else if (*end != '\0') return false;
+        text = end;
+    }
+    return !outValues.empty();
+}
+
+static bool ParseBroadPhase(const char* name, int& outType)
+{
+    if (strcmp(name, "hash") == 0) outType = BroadPhase_SpatialHash;
+    else if (strcmp(name, "sap") == 0) outType = BroadPhase_SweepAndPrune;
+    else if (strcmp(name, "brute") == 0) outType = BroadPhase_BruteForce;
+    else return false;
+    return true;
+}
+
+static bool ParseSolver(const char* name, int& outType)
+{
+    if (strcmp(name, "impulse") == 0) outType = Solver_Impulse;
+    else if (strcmp(name, "xpbd") == 0) outType = Solver_XpbdGaussSeidel;
+    else if (strcmp(name, "xpbd-jacobi") == 0) outType = Solver_XpbdJacobi;
+    else return false;
+    return true;
+}
+
+static const char* GetSolverName(int type)
+{
+    switch (type)
+    {
+    case Solver_XpbdGaussSeidel: return "xpbd";
+    case Solver_XpbdJacobi: return "xpbd-jacobi";
+    default: return "impulse";
+    }
+}
+
+// 쉼표로 구분한 솔버 이름 목록
+static bool ParseSolverList(const char* text, std::vector<int>& outTypes)
+{
+    outTypes.clear();
+    char name[32];
+    while (*text)
+    {
+        const char* end = strchr(text, ',');
+        const size_t length = end ? (size_t)(end - text) : strlen(text);
+        if (length >= sizeof(name)) return false;
+        memcpy(name, text, length);
+        name[length] = '\0';
+
+        int type = Solver_Impulse;
+        if (!ParseSolver(name, type)) return false;
+        outTypes.push_back(type);
+        text = end ? end + 1 : text + length;
+    }
+    return !outTypes.empty();
+}
+
+static bool ParseObstacleLayout(const char* name, int& outLayout)
+{
+    if (strcmp(name, "none") == 0) outLayout = ObstacleLayout_None;
+    else if (strcmp(name, "pegs") == 0) outLayout = ObstacleLayout_Pegs;
+    else if (strcmp(name, "funnel") == 0) outLayout = ObstacleLayout_Funnel;
+    else return false;
+    return true;
+}
+
+static const char* GetObstacleLayoutName(int layout)
+{
+    switch (layout)
+    {
+    case ObstacleLayout_Pegs: return "pegs";
+    case ObstacleLayout_Funnel: return "funnel";
+    default: return "none";
+    }
+}
+
+static bool ParseContainerShape(const char* name, int& outShape)
+{
+    if (strcmp(name, "box") == 0) outShape = Container_Box;
+    else if (strcmp(name, "circle") == 0) outShape = Container_Circle;
+    else if (strcmp(name, "star") == 0) outShape = Container_Star;
+    else if (strcmp(name, "mask") == 0) outShape = Container_Mask;
+    else return false;
+    return true;
+}
+
+static const char* GetContainerShapeName(int shape)
+{
+    switch (shape)
+    {
+    case Container_Circle: return "circle";
+    case Container_Star: return "star";
+    case Container_Mask: return "mask";
+    default: return "box";
+    }
+}
+
+static const char* GetBroadPhaseName(int type)
+{
+    switch (type)
+    {
+    case BroadPhase_SweepAndPrune: return "sap";
+    case BroadPhase_BruteForce: return "brute";
+    default: return "hash";
+    }
+}
+
+static bool ParseOptions(int argc, char** argv, FBenchOptions& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (strcmp(arg, "--no-gravity") == 0) { options.Gravity = false; continue; }
+        if (strcmp(arg, "--3d") == 0) { options.Enable3D = true; continue; }
+        if (strcmp(arg, "--no-ccd") == 0) { options.Ccd = false; continue; }
+        if (strcmp(arg, "--no-sleep") == 0) { options.Sleeping = false; continue; }
+        if (strcmp(arg, "--deterministic") == 0) { options.Deterministic = true; continue; }
+        if (strcmp(arg, "--adaptive") == 0) { options.AdaptiveSubsteps = true; continue; }
+        if (!value) return false;
+
+        if (strcmp(arg, "--balls") == 0) options.NumBalls = atoi(value);
+        else if (strcmp(arg, "--steps") == 0) options.NumSteps = atoi(value);
+        else if (strcmp(arg, "--warmup") == 0) options.NumWarmupSteps = atoi(value);
+        else if (strcmp(arg, "--seed") == 0) options.Seed = (unsigned)strtoul(value, nullptr, 10);
+        else if (strcmp(arg, "--threads") == 0) options.Threads = atoi(value);
+        else if (strcmp(arg, "--passes") == 0) options.CollisionPasses = atoi(value);
+        else if (strcmp(arg, "--max-substeps") == 0) options.MaxSubsteps = atoi(value);
+        else if (strcmp(arg, "--reorder") == 0) options.ReorderInterval = atoi(value);
+        else if (strcmp(arg, "--dt") == 0) options.StepTime = (float)atof(value);
+        else if (strcmp(arg, "--radius-scale") == 0) options.RadiusScale = (float)atof(value);
+        else if (strcmp(arg, "--broadphase") == 0) { if (!ParseBroadPhase(value, options.BroadPhase)) return false; }
+        else if (strcmp(arg, "--solver") == 0) { if (!ParseSolver(value, options.Solver)) return false; }
+        else if (strcmp(arg, "--xpbd-iterations") == 0) options.XpbdIterations = atoi(value);
+        else if (strcmp(arg, "--xpbd-substeps") == 0) options.XpbdSubsteps = atoi(value);
+        else if (strcmp(arg, "--container") == 0) { if (!ParseContainerShape(value, options.ContainerShape)) return false; }
+        else if (strcmp(arg, "--container-mask") == 0) options.ContainerMaskPath = value;
+        else if (strcmp(arg, "--obstacles") == 0) { if (!ParseObstacleLayout(value, options.ObstacleLayout)) return false; }
+        else if (strcmp(arg, "--sweep-restitution") == 0) { if (!ParseList(value, options.SweepRestitution)) return false; }
+        else if (strcmp(arg, "--sweep-wall") == 0) { if (!ParseList(value, options.SweepWallRestitution)) return false; }
+        else if (strcmp(arg, "--sweep-gravity") == 0) { if (!ParseList(value, options.SweepGravity)) return false; }
+        else if (strcmp(arg, "--sweep-balls") == 0) { if (!ParseList(value, options.SweepBalls)) return false; }
+        else if (strcmp(arg, "--sweep-solver") == 0) { if (!ParseSolverList(value, options.SweepSolvers)) return false; }
+        else if (strcmp(arg, "--sweep-passes") == 0) { if (!ParseList(value, options.SweepPasses)) return false; }
+        else if (strcmp(arg, "--sweep-seeds") == 0) options.SweepSeeds = atoi(value);
+        else if (strcmp(arg, "--max-mean-speed") == 0) options.MaxMeanSpeed = (float)atof(value);
+        else return false;
+        i++;
+    }
+    return options.NumBalls >= 0 && options.NumSteps > 0 && options.NumWarmupSteps >= 0 &&
+           options.CollisionPasses > 0 && options.ReorderInterval >= 0 && options.StepTime > 0.0f && options.RadiusScale > 0.0f &&
+           options.SweepSeeds >= 0 && options.MaxSubsteps > 0 && options.XpbdIterations > 0 && options.XpbdSubsteps > 0;
+}
+
+// 스윕 목록의 조합마다 월드를 하나씩 만들어 FBatchSimulation으로 같이 돌리고 월드별 결과를 한 줄씩 출력한다
+static int RunSweep(const FBenchOptions& options, FJobSystem& jobs)
+{
+    if (options.ContainerMaskPath)
+    {
+        fprintf(stderr, "--container-mask is not supported with sweeps\n");
+        return 1;
+    }
+
+    FBatchSimulation batch(jobs);
+    batch.Config.StepTime = options.StepTime;
+    batch.Config.Enable3D = options.Enable3D;
+    batch.Config.EnableCcd = options.Ccd;
+    batch.Config.EnableSleeping = options.Sleeping;
+    batch.Config.EnableAdaptiveSubsteps = options.AdaptiveSubsteps;
+    batch.Config.MaxSubsteps = options.MaxSubsteps;
+    batch.Config.ReorderInterval = options.ReorderInterval;
+    batch.Config.BroadPhaseType = options.BroadPhase;
+    batch.Config.XpbdIterations = options.XpbdIterations;
+    batch.Config.XpbdSubsteps = options.XpbdSubsteps;
+    batch.Config.ObstacleLayout = options.ObstacleLayout;
+    batch.Config.ContainerShape = options.ContainerShape;
+    batch.Config.SpawnRadiusScale = options.RadiusScale;
+
+    // 주어지지 않은 목록은 단일 실행과 같은 값 하나로 채운다
+    const FWorldParams defaults;
+    const std::vector<float> restitutions = !options.SweepRestitution.empty() ? options.SweepRestitution : std::vector<float>(1, defaults.Restitution);
+    const std::vector<float> walls = !options.SweepWallRestitution.empty() ? options.SweepWallRestitution : std::vector<float>(1, defaults.WallRestitution);
+    const std::vector<float> gravities = !options.SweepGravity.empty() ? options.SweepGravity : std::vector<float>(1, options.Gravity ? defaults.GravityAcceleration : 0.0f);
+    const std::vector<float> ballCounts = !options.SweepBalls.empty() ? options.SweepBalls : std::vector<float>(1, (float)options.NumBalls);
+    const std::vector<int> solvers = !options.SweepSolvers.empty() ? options.SweepSolvers : std::vector<int>(1, options.Solver);
+    const std::vector<float> passCounts = !options.SweepPasses.empty() ? options.SweepPasses : std::vector<float>(1, (float)options.CollisionPasses);
+    const int numSeeds = std::max(options.SweepSeeds, 1);
+
+    for (int solver : solvers)
+        for (float passes : passCounts)
+            for (float restitution : restitutions)
+                for (float wall : walls)
+                    for (float gravity : gravities)
+                        for (float balls : ballCounts)
+                            for (int seed = 0; seed < numSeeds; seed++)
+                            {
+                                FWorldParams params;
+                                params.SolverType = solver;
+                                params.CollisionPasses = std::max((int)passes, 1);
+                                params.Restitution = restitution;
+                                params.WallRestitution = wall;
+                                params.EnableGravity = gravity != 0.0f;
+                                params.GravityAcceleration = gravity;
+                                params.NumBalls = (int)balls;
+                                params.Seed = options.Seed + (unsigned)seed;
+                                batch.AddWorld(params);
+                            }
+
+    batch.Step(options.NumWarmupSteps);
+    const double warmupSeconds = batch.GetLastSeconds();
+    batch.ResetStats();
+    batch.Step(options.NumSteps);
+    const double seconds = batch.GetLastSeconds();
+
+    printf("world  solver       passes  restitution  wall   gravity  balls   seed  ns_per_ball_step  contacts_per_step  substeps  awake  mean_speed  mean_height  position_hash\n");
+    double ballSteps = 0.0;
+    int numTooFast = 0;
+    for (int w = 0; w < batch.GetNumWorlds(); w++)
+    {
+        const FWorldParams& params = batch.GetParams(w);
+        const FWorldStats& stats = batch.GetStats(w);
+        ballSteps += (double)stats.NumBalls * stats.NumSteps;
+        if (options.MaxMeanSpeed > 0.0f && stats.MeanSpeed > options.MaxMeanSpeed)
+            numTooFast++;
+        printf("%5d  %-11s  %6d  %11.3f  %5.3f  %7.2f  %6d  %5u  %16.2f  %17.1f  %8.2f  %5d  %10.4f  %11.4f  %016llx\n",
+            w, GetSolverName(params.SolverType), params.CollisionPasses, params.Restitution, params.WallRestitution, params.EnableGravity ? params.GravityAcceleration : 0.0f,
+            stats.NumBalls, params.Seed, stats.GetNsPerBallStep(), stats.GetContactsPerStep(), stats.GetSubstepsPerStep(), stats.NumAwake,
+            stats.MeanSpeed, stats.MeanHeight, (unsigned long long)stats.PositionHash);
+    }
+
+    printf("worlds:             %d\n", batch.GetNumWorlds());
+    printf("steps:              %d (+%d warmup)\n", options.NumSteps, options.NumWarmupSteps);
+    printf("threads:            %d\n", jobs.GetNumThreads());
+    printf("warmup_s:           %.4f\n", warmupSeconds);
+    printf("elapsed_s:          %.4f\n", seconds);
+    printf("ball_steps_per_sec: %.0f\n", seconds > 0.0 ? ballSteps / seconds : 0.0);
+    if (numTooFast > 0)
+    {
+        fprintf(stderr, "%d world(s) ended with mean speed above %.4f\n", numTooFast, options.MaxMeanSpeed);
+        return 2;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    FBenchOptions options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    FJobSystem jobs;
+    jobs.Start(options.Threads);
+    jobs.Deterministic = options.Deterministic;
+
+    if (options.IsSweep())
+    {
+        const int result = RunSweep(options, jobs);
+        jobs.Shutdown();
+        return result;
+    }
+
+    FBallSimulation simulation(jobs);
+    simulation.EnableGravity = options.Gravity;
+    simulation.Enable3D = options.Enable3D;
+    simulation.EnableCcd = options.Ccd;
+    simulation.World.EnableSleeping = options.Sleeping;
+    simulation.CollisionPasses = options.CollisionPasses;
+    simulation.EnableAdaptiveSubsteps = options.AdaptiveSubsteps;
+    simulation.MaxSubsteps = options.MaxSubsteps;
+    simulation.ReorderInterval = options.ReorderInterval;
+    simulation.BroadPhaseType = options.BroadPhase;
+    simulation.SolverType = options.Solver;
+    simulation.PositionSolver.Iterations = options.XpbdIterations;
+    simulation.XpbdSubsteps = options.XpbdSubsteps;
+    simulation.SpawnRadiusScale = options.RadiusScale;
+    simulation.SetObstacleLayout(options.ObstacleLayout);
+    simulation.SetContainerShape(options.ContainerShape);
+    if (options.ContainerMaskPath && !simulation.LoadContainerMask(options.ContainerMaskPath))
+    {
+        fprintf(stderr, "cannot read container mask %s\n", options.ContainerMaskPath);
+        return 1;
+    }
+
+    simulation.Random.Seed(options.Seed);
+    const std::chrono::steady_clock::time_point spawnBegin = std::chrono::steady_clock::now();
+    simulation.SetBallCount(options.NumBalls);
+    const double spawnSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - spawnBegin).count();
+
+    for (int step = 0; step < options.NumWarmupSteps; step++)
+        simulation.Step(options.StepTime);
+
+    // 시간 측정 구간
+    uint64_t totalPairs = 0;
+    uint64_t totalContacts = 0;
+    uint64_t totalAwake = 0;
+    uint64_t totalObstacleContacts = 0;
+    uint64_t totalSubsteps = 0;
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (int step = 0; step < options.NumSteps; step++)
+    {
+        simulation.Step(options.StepTime);
+        totalPairs += simulation.CollisionPairs.size();
+        totalContacts += (uint64_t)simulation.NumContacts;
+        totalAwake += simulation.World.GetAwakeBalls().size();
+        totalObstacleContacts += simulation.ObstacleContacts.size();
+        totalSubsteps += (uint64_t)simulation.LastSubsteps;
+    }
+    const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    const double seconds = std::chrono::duration<double>(end - begin).count();
+    const double ballSteps = (double)options.NumBalls * options.NumSteps;
+
+    printf("balls:              %d\n", options.NumBalls);
+    printf("steps:              %d (+%d warmup)\n", options.NumSteps, options.NumWarmupSteps);
+    printf("seed:               %u\n", options.Seed);
+    printf("threads:            %d\n", jobs.GetNumThreads());
+    printf("simd:               %s\n", GetSimdLevelName(ActiveSimdLevel()));
+    printf("broadphase:         %s\n", GetBroadPhaseName(options.BroadPhase));
+    printf("solver:             %s\n", GetSolverName(options.Solver));
+    printf("mode:               %s\n", options.Enable3D ? "3d" : "2d");
+    printf("container:          %s\n", options.ContainerMaskPath ? options.ContainerMaskPath : GetContainerShapeName(options.ContainerShape));
+    printf("obstacles:          %s (%d)\n", GetObstacleLayoutName(options.ObstacleLayout), simulation.Obstacles.GetNumObstacles());
+    printf("radius_scale:       %.3f\n", options.RadiusScale);
+    printf("reorder_interval:   %d\n", options.ReorderInterval);
+    printf("spawn_ms:           %.3f\n", spawnSeconds * 1e3);
+    printf("spawn_overlaps:     %d\n", simulation.Spawner.NumOverlapped);
+    printf("elapsed_s:          %.4f\n", seconds);
+    printf("steps_per_sec:      %.2f\n", options.NumSteps / seconds);
+    printf("ns_per_ball_step:   %.2f\n", ballSteps > 0.0 ? seconds * 1e9 / ballSteps : 0.0);
+    printf("pairs_per_step:     %.1f\n", (double)totalPairs / options.NumSteps);
+    printf("contacts_per_step:  %.1f\n", (double)totalContacts / options.NumSteps);
+    printf("obstacle_contacts:  %.1f\n", (double)totalObstacleContacts / options.NumSteps);
+    printf("awake_per_step:     %.1f\n", (double)totalAwake / options.NumSteps);
+    printf("substeps_per_step:  %.2f%s\n", (double)totalSubsteps / options.NumSteps, options.AdaptiveSubsteps ? " (adaptive)" : "");
+    if (options.Solver != Solver_Impulse)
+        printf("xpbd_max_error:     %.6f (%d constraints)\n", simulation.PositionSolver.MaxError, simulation.PositionSolver.NumConstraints);
+    printf("final_pairs:        %d\n", (int)simulation.CollisionPairs.size());
+    printf("position_hash:      %016llx\n", (unsigned long long)simulation.World.HashPositions());
+
+    const FBallWorld& balls = simulation.World;
+    double sumSpeed = 0.0;
+    for (int i = 0; i < balls.Count; i++)
+        sumSpeed += sqrtf(balls.VelX[i] * balls.VelX[i] + balls.VelY[i] * balls.VelY[i] + balls.VelZ[i] * balls.VelZ[i]);
+    const float meanSpeed = balls.Count > 0 ? (float)(sumSpeed / balls.Count) : 0.0f;
+    printf("mean_speed:         %.4f\n", meanSpeed);
+
+    jobs.Shutdown();
+    if (options.MaxMeanSpeed > 0.0f && meanSpeed > options.MaxMeanSpeed)
+    {
+        fprintf(stderr, "mean speed %.4f is above %.4f\n", meanSpeed, options.MaxMeanSpeed);
+        return 2;
+    }
+    return 0;
+}
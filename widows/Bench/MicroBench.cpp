@@ -0,0 +1,569 @@
+// 물리 핫 패스 마이크로벤치마크
+// FVector 연산, 도형 충돌 분기, 장애물/용기 접촉, 공 추가/제거, 적분, 브로드페이즈, Morton 재배치, 좁은 단계, 전체 스텝을 공 수/중력/반지름 분포별로 재서 JSON으로 출력한다.
+// --baseline으로 이전 결과를 주면 항목마다 비교하고, 기준보다 느려진 항목이 있으면 0이 아닌 값으로 끝난다.
+// 예) MicroBench --out base.json
+//     MicroBench --baseline base.json --threshold 10
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "../Physics/BallSimulation.h"
+#include "../Physics/Primitive.h"
+
+// 결과가 최적화로 사라지지 않도록 여기에 더해 둔다
+static volatile float Sink = 0.0f;
+
+struct FBenchOptions
+{
+    std::vector<int> Sizes = { 1000, 10000, 100000 };
+    std::string Filter;        // 이름에 이 문자열이 들어간 항목만
+    std::string OutPath;       // 비어 있으면 표준 출력
+    std::string BaselinePath;
+    double Threshold = 10.0;   // 기준보다 이 퍼센트 이상 느리면 회귀
+    double MinTime = 0.2;      // 항목마다 최소 측정 시간 (초)
+    int Threads = 1;
+    unsigned Seed = 1;
+};
+
+struct FBenchResult
+{
+    std::string Name;
+    int NumBalls = 0;
+    bool Gravity = false;
+    std::string RadiusDistribution;
+    int Iterations = 0;
+    double NsPerOp = 0.0;      // 반복 한 번 시간의 중앙값
+    double NsMin = 0.0;
+    double NsPerBall = 0.0;
+
+    std::string GetKey() const
+    {
+        return Name + "/" + std::to_string(NumBalls) + "/" + (Gravity ? "gravity" : "nogravity") + "/" + RadiusDistribution;
+    }
+};
+
+// 반지름 분포: 공 수에 따라 상자([-1, 1]^2) 면적의 약 30%를 덮도록 기준 반지름을 잡는다
+enum ERadiusDistribution
+{
+    Radius_Uniform,  // 모두 같은 반지름
+    Radius_Mixed,    // 기준의 0.5 ~ 1.5배
+    Radius_Bimodal,  // 90%는 기준의 0.7배, 10%는 2.5배
+    Radius_Count,
+};
+
+static const char* GetRadiusName(int distribution)
+{
+    switch (distribution)
+    {
+    case Radius_Mixed: return "mixed";
+    case Radius_Bimodal: return "bimodal";
+    default: return "uniform";
+    }
+}
+
+static float GetBaseRadius(int numBalls)
+{
+    const float coverage = 0.3f;
+    return sqrtf(coverage * 4.0f / (3.14159265f * (float)numBalls));
+}
+
+// 같은 seed면 플랫폼과 관계없이 같은 장면이 되도록 mt19937로 공을 만든다
+static void SpawnBalls(FBallWorld& world, int numBalls, int distribution, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(-0.9f, 0.9f);
+    std::uniform_real_distribution<float> velocity(-0.7f, 0.7f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    const float baseRadius = GetBaseRadius(numBalls);
+
+    world.Clear();
+    world.Reserve(numBalls);
+    for (int i = 0; i < numBalls; i++)
+    {
+        float radius = baseRadius;
+        if (distribution == Radius_Mixed)
+            radius = baseRadius * (0.5f + unit(rng));
+        else if (distribution == Radius_Bimodal)
+            radius = baseRadius * (unit(rng) < 0.9f ? 0.7f : 2.5f);
+
+        const float x = position(rng);
+        const float y = position(rng);
+        const float vx = velocity(rng);
+        const float vy = velocity(rng);
+        world.Add(FVector(x, y, 0.0f), FVector(vx, vy, 0.0f), radius);
+    }
+}
+
+class FBenchRunner
+{
+public:
+    explicit FBenchRunner(const FBenchOptions& options)
+        : Options(options)
+    {
+    }
+
+    std::vector<FBenchResult> Results;
+
+    bool IsEnabled(const char* name) const
+    {
+        return Options.Filter.empty() || strstr(name, Options.Filter.c_str()) != nullptr;
+    }
+
+    // run()을 MinTime 동안 반복해서 한 번 시간의 중앙값과 최솟값을 기록한다
+    template <typename Func>
+    void Measure(const char* name, int numBalls, bool gravity, const char* radius, Func run)
+    {
+        run(); // 캐시와 버퍼를 데우는 한 번
+
+        std::vector<double> samples;
+        double total = 0.0;
+        while (total < Options.MinTime * 1e9 || samples.size() < 3)
+        {
+            const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+            run();
+            const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+            const double ns = std::chrono::duration<double, std::nano>(end - begin).count();
+            samples.push_back(ns);
+            total += ns;
+        }
+        std::sort(samples.begin(), samples.end());
+
+        FBenchResult result;
+        result.Name = name;
+        result.NumBalls = numBalls;
+        result.Gravity = gravity;
+        result.RadiusDistribution = radius;
+        result.Iterations = (int)samples.size();
+        result.NsPerOp = samples[samples.size() / 2];
+        result.NsMin = samples.front();
+        result.NsPerBall = numBalls > 0 ? result.NsPerOp / numBalls : 0.0;
+        Results.push_back(result);
+
+        fprintf(stderr, "%-40s %12.0f ns/op %9.2f ns/ball (%d iterations)\n",
+            result.GetKey().c_str(), result.NsPerOp, result.NsPerBall, result.Iterations);
+    }
+
+private:
+    const FBenchOptions& Options;
+};
+
+// FVector 연산: 공 수만큼의 벡터 배열에 대해 한 번씩
+static void RunVectorBenchmarks(FBenchRunner& runner, int numBalls, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+    std::vector<FVector> a(numBalls);
+    std::vector<FVector> b(numBalls);
+    for (int i = 0; i < numBalls; i++)
+    {
+        a[i] = FVector(value(rng), value(rng), value(rng));
+        b[i] = FVector(value(rng), value(rng), value(rng));
+    }
+
+    if (runner.IsEnabled("vector_dot"))
+    {
+        runner.Measure("vector_dot", numBalls, false, "none", [&]()
+        {
+            float sum = 0.0f;
+            for (int i = 0; i < numBalls; i++)
+                sum += a[i].Dot(b[i]);
+            Sink = Sink + sum;
+        });
+    }
+
+    if (runner.IsEnabled("vector_cross"))
+    {
+        runner.Measure("vector_cross", numBalls, false, "none", [&]()
+        {
+            FVector sum;
+            for (int i = 0; i < numBalls; i++)
+                sum += a[i].Cross(b[i]);
+            Sink = Sink + sum.x + sum.y + sum.z;
+        });
+    }
+
+    if (runner.IsEnabled("vector_safe_normal"))
+    {
+        runner.Measure("vector_safe_normal", numBalls, false, "none", [&]()
+        {
+            FVector sum;
+            for (int i = 0; i < numBalls; i++)
+                sum += a[i].GetSafeNormal();
+            Sink = Sink + sum.x + sum.y + sum.z;
+        });
+    }
+}
+
+// 도형 충돌 분기: 구 n개를 평면/상자가 섞인 도형 8개와 UPrimitive::Collision으로 검사
+static void RunShapeBenchmarks(FBenchRunner& runner, int numBalls, unsigned seed)
+{
+    if (!runner.IsEnabled("shape_dispatch")) return;
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+    std::vector<USphere> spheres(numBalls);
+    for (int i = 0; i < numBalls; i++)
+        spheres[i] = USphere(FVector(value(rng), value(rng), 0.0f), 0.05f);
+
+    std::vector<UPlane> planes;
+    std::vector<UBox> boxes;
+    for (int k = 0; k < 4; k++)
+    {
+        planes.push_back(UPlane(FVector(value(rng), value(rng), 0.0f), value(rng)));
+        boxes.push_back(UBox(FVector(value(rng), value(rng), 0.0f), FVector(0.2f, 0.1f, 0.5f)));
+        boxes.back().SetRotationZ(value(rng));
+    }
+    std::vector<const UPrimitive*> shapes;
+    for (int k = 0; k < 4; k++)
+    {
+        shapes.push_back(&planes[k]);
+        shapes.push_back(&boxes[k]);
+    }
+
+    runner.Measure("shape_dispatch", numBalls, false, "none", [&]()
+    {
+        FShapeContact contact;
+        float sum = 0.0f;
+        for (int i = 0; i < numBalls; i++)
+        {
+            for (const UPrimitive* shape : shapes)
+            {
+                if (spheres[i].Collision(shape, &contact))
+                    sum += contact.Penetration;
+            }
+        }
+        Sink = Sink + sum;
+    });
+}
+
+// 장애물 접촉: 모든 공과 장애물(또는 용기)의 접촉 찾기
+// obstacle_contacts는 막대 208개 (정적 BVH 질의 + 도형 검사), container_contacts는 별 모양 용기 (거리장 한 번)
+static void RunObstacleBenchmarks(FBenchRunner& runner, FJobSystem& jobs, int numBalls, unsigned seed)
+{
+    const char* names[2] = { "obstacle_contacts", "container_contacts" };
+    for (int k = 0; k < 2; k++)
+    {
+        if (!runner.IsEnabled(names[k])) continue;
+
+        FBallSimulation simulation(jobs);
+        simulation.Random.Seed(seed);
+        simulation.SpawnRadiusScale = GetBaseRadius(numBalls) / 0.185f; // 평균 반지름이 다른 항목과 같도록
+        if (k == 0)
+            simulation.SetObstacleLayout(ObstacleLayout_Pegs);
+        else
+            simulation.SetContainerShape(Container_Star);
+        simulation.SetBallCount(numBalls);
+
+        runner.Measure(names[k], numBalls, false, "uniform", [&]()
+        {
+            simulation.Obstacles.FindContacts(simulation.World, simulation.World.GetAwakeBalls(), jobs, simulation.ObstacleContacts);
+            Sink = Sink + (float)simulation.ObstacleContacts.size();
+        });
+    }
+}
+
+// 공 n개를 한꺼번에 만들고 다시 모두 지우기 (용량은 첫 반복 뒤로 재사용된다)
+static void RunSpawnBenchmarks(FBenchRunner& runner, FJobSystem& jobs, int numBalls)
+{
+    if (!runner.IsEnabled("spawn_remove")) return;
+
+    FBallSimulation simulation(jobs);
+    simulation.Random.Seed(1);
+    runner.Measure("spawn_remove", numBalls, false, "none", [&]()
+    {
+        simulation.SetBallCount(numBalls);
+        simulation.SetBallCount(0);
+    });
+}
+
+// 적분, 브로드페이즈, 좁은 단계, 전체 스텝
+static void RunWorldBenchmarks(FBenchRunner& runner, const FBenchOptions& options, FJobSystem& jobs, int numBalls, int distribution)
+{
+    const char* radius = GetRadiusName(distribution);
+    const float dt = 1.0f / 60.0f;
+
+    for (int gravity = 0; gravity < 2; gravity++)
+    {
+        const float gravityY = gravity ? -9.8f : 0.0f;
+
+        if (runner.IsEnabled("integrate"))
+        {
+            FBallWorld world;
+            SpawnBalls(world, numBalls, distribution, options.Seed);
+            runner.Measure("integrate", numBalls, gravity != 0, radius, [&]()
+            {
+                world.Update(dt, gravityY, jobs);
+            });
+        }
+
+        if (runner.IsEnabled("frame_step"))
+        {
+            FBallSimulation simulation(jobs);
+            simulation.EnableGravity = gravity != 0;
+            SpawnBalls(simulation.World, numBalls, distribution, options.Seed);
+            runner.Measure("frame_step", numBalls, gravity != 0, radius, [&]()
+            {
+                simulation.Step(dt);
+            });
+        }
+    }
+
+    // 위치가 그대로인 장면에서 쌍 찾기와 접촉 생성만 잰다 (중력과 무관)
+    FBallWorld world;
+    SpawnBalls(world, numBalls, distribution, options.Seed);
+    std::vector<FCollisionPair> pairs;
+
+    if (runner.IsEnabled("broadphase_hash"))
+    {
+        FSpatialHash hash;
+        runner.Measure("broadphase_hash", numBalls, false, radius, [&]()
+        {
+            hash.FindPairs(world.PosX, world.PosY, world.PosZ, world.Radius, world.Count, jobs, pairs);
+        });
+    }
+
+    if (runner.IsEnabled("broadphase_sap"))
+    {
+        // 위치가 변하지 않으므로 처음 한 번 만든 뒤로는 점진적 갱신 비용만 남는다
+        FSweepAndPrune sweepAndPrune;
+        runner.Measure("broadphase_sap", numBalls, false, radius, [&]()
+        {
+            sweepAndPrune.FindPairs(world.PosX, world.PosY, world.PosZ, world.Radius, world.Count, pairs);
+        });
+    }
+
+    if (runner.IsEnabled("morton_reorder"))
+    {
+        // 첫 반복 뒤로는 이미 정렬된 순서지만 코드 계산, 정렬, 배열 재배치 비용은 같다
+        FBallWorld sorted;
+        SpawnBalls(sorted, numBalls, distribution, options.Seed);
+        FMortonOrder mortonOrder;
+        runner.Measure("morton_reorder", numBalls, false, radius, [&]()
+        {
+            const std::vector<int>& order = mortonOrder.Compute(sorted.PosX, sorted.PosY, sorted.PosZ, sorted.Count);
+            sorted.Reorder(order.data());
+        });
+    }
+
+    if (runner.IsEnabled("narrowphase"))
+    {
+        FSpatialHash hash;
+        hash.FindPairs(world.PosX, world.PosY, world.PosZ, world.Radius, world.Count, jobs, pairs);
+        std::vector<FContact> contacts(pairs.size());
+        const FBallArrays arrays = world.GetArrays();
+        runner.Measure("narrowphase", numBalls, false, radius, [&]()
+        {
+            const int numContacts = FindContacts(arrays, pairs.data(), 0, (int)pairs.size(), contacts.data());
+            Sink = Sink + (float)numContacts;
+        });
+    }
+}
+
+static void WriteJson(FILE* file, const FBenchOptions& options, FJobSystem& jobs, const std::vector<FBenchResult>& results)
+{
+    // 기준 비교에서 줄 단위로 읽을 수 있도록 항목 하나를 한 줄에 쓴다
+    fprintf(file, "{\n");
+    fprintf(file, "  \"context\": {\"simd\": \"%s\", \"threads\": %d, \"seed\": %u, \"min_time_s\": %.3f},\n",
+        GetSimdLevelName(ActiveSimdLevel()), jobs.GetNumThreads(), options.Seed, options.MinTime);
+    fprintf(file, "  \"benchmarks\": [\n");
+    for (size_t r = 0; r < results.size(); r++)
+    {
+        const FBenchResult& result = results[r];
+        fprintf(file, "    {\"name\": \"%s\", \"balls\": %d, \"gravity\": %s, \"radius\": \"%s\", \"iterations\": %d, "
+            "\"ns_per_op\": %.1f, \"ns_min\": %.1f, \"ns_per_ball\": %.3f}%s\n",
+            result.Name.c_str(), result.NumBalls, result.Gravity ? "true" : "false", result.RadiusDistribution.c_str(),
+            result.Iterations, result.NsPerOp, result.NsMin, result.NsPerBall, r + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+}
+
+// "key": "value" 또는 "key": value 에서 value를 꺼낸다
+static bool FindJsonValue(const std::string& line, const char* key, std::string& outValue)
+{
+    const std::string pattern = std::string("\"") + key + "\":";
+    size_t pos = line.find(pattern);
+    if (pos == std::string::npos) return false;
+    pos += pattern.size();
+    while (pos < line.size() && line[pos] == ' ') pos++;
+
+    if (pos < line.size() && line[pos] == '"')
+    {
+        const size_t end = line.find('"', pos + 1);
+        if (end == std::string::npos) return false;
+        outValue = line.substr(pos + 1, end - pos - 1);
+        return true;
+    }
+    const size_t end = line.find_first_of(",}", pos);
+    outValue = line.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+    return true;
+}
+
+// 이 도구가 쓴 JSON 파일에서 결과를 읽는다
+// 결과가 하나도 없으면 (다른 형식이나 엉뚱한 파일) 비교 없이 통과하지 않도록 false
+static bool ReadBaseline(const std::string& path, std::vector<FBenchResult>& outResults)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) return false;
+
+    std::string line;
+    char buffer[1024];
+    while (fgets(buffer, sizeof(buffer), file))
+    {
+        line = buffer;
+        std::string name, balls, gravity, radius, nsPerOp;
+        if (!FindJsonValue(line, "name", name) || !FindJsonValue(line, "balls", balls) || !FindJsonValue(line, "gravity", gravity) ||
+            !FindJsonValue(line, "radius", radius) || !FindJsonValue(line, "ns_per_op", nsPerOp)) continue;
+
+        FBenchResult result;
+        result.Name = name;
+        result.NumBalls = atoi(balls.c_str());
+        result.Gravity = gravity == "true";
+        result.RadiusDistribution = radius;
+        result.NsPerOp = atof(nsPerOp.c_str());
+        outResults.push_back(result);
+    }
+    fclose(file);
+    return !outResults.empty();
+}
+
+// 같은 키의 항목끼리 비교해 표로 출력하고, 회귀한 항목 수를 반환한다
+static int CompareWithBaseline(const std::vector<FBenchResult>& baseline, const std::vector<FBenchResult>& results, double threshold)
+{
+    int numRegressed = 0;
+    fprintf(stderr, "\n%-40s %14s %14s %9s\n", "benchmark", "baseline ns", "current ns", "change");
+    for (const FBenchResult& result : results)
+    {
+        const std::string key = result.GetKey();
+        const FBenchResult* base = nullptr;
+        for (const FBenchResult& candidate : baseline)
+        {
+            if (candidate.GetKey() == key)
+            {
+                base = &candidate;
+                break;
+            }
+        }
+        if (!base || base->NsPerOp <= 0.0)
+        {
+            fprintf(stderr, "%-40s %14s %14.0f %9s\n", key.c_str(), "-", result.NsPerOp, "new");
+            continue;
+        }
+
+        const double change = (result.NsPerOp / base->NsPerOp - 1.0) * 100.0;
+        const bool bRegressed = change > threshold;
+        if (bRegressed) numRegressed++;
+        fprintf(stderr, "%-40s %14.0f %14.0f %+8.1f%%%s\n", key.c_str(), base->NsPerOp, result.NsPerOp, change, bRegressed ? "  REGRESSED" : "");
+    }
+    fprintf(stderr, "%d regression(s) over %.1f%%\n", numRegressed, threshold);
+    return numRegressed;
+}
+
+static void PrintUsage(const char* program)
+{
+    printf("usage: %s [options]\n", program);
+    printf("  --sizes A,B,C      ball counts (default 1000,10000,100000)\n");
+    printf("  --filter TEXT      only benchmarks whose name contains TEXT\n");
+    printf("  --out FILE         write JSON to FILE instead of stdout\n");
+    printf("  --baseline FILE    compare against a previous JSON result\n");
+    printf("  --threshold PCT    slowdown that counts as a regression (default 10)\n");
+    printf("  --min-time SEC     minimum measuring time per benchmark (default 0.2)\n");
+    printf("  --threads T        worker threads including main, 0 = all cores (default 1)\n");
+    printf("  --seed S           scene seed (default 1)\n");
+}
+
+static bool ParseSizes(const char* text, std::vector<int>& outSizes)
+{
+    outSizes.clear();
+    while (*text)
+    {
+        char* end = nullptr;
+        const long size = strtol(text, &end, 10);
+        if (end == text || size <= 0) return false;
+        outSizes.push_back((int)size);
+        text = *end == ',' ? end + 1 : end;
+    }
+    return !outSizes.empty();
+}
+
+static bool ParseOptions(int argc, char** argv, FBenchOptions& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!value) return false;
+
+        if (strcmp(arg, "--sizes") == 0) { if (!ParseSizes(value, options.Sizes)) return false; }
+        else if (strcmp(arg, "--filter") == 0) options.Filter = value;
+        else if (strcmp(arg, "--out") == 0) options.OutPath = value;
+        else if (strcmp(arg, "--baseline") == 0) options.BaselinePath = value;
+        else if (strcmp(arg, "--threshold") == 0) options.Threshold = atof(value);
+        else if (strcmp(arg, "--min-time") == 0) options.MinTime = atof(value);
+        else if (strcmp(arg, "--threads") == 0) options.Threads = atoi(value);
+        else if (strcmp(arg, "--seed") == 0) options.Seed = (unsigned)strtoul(value, nullptr, 10);
+        else return false;
+        i++;
+    }
+    return options.MinTime >= 0.0 && options.Threshold >= 0.0;
+}
+
+int main(int argc, char** argv)
+{
+    FBenchOptions options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    // 기준 파일은 측정 전에 읽어서, 잘못된 경로면 오래 돌기 전에 끝낸다
+    std::vector<FBenchResult> baseline;
+    if (!options.BaselinePath.empty() && !ReadBaseline(options.BaselinePath, baseline))
+    {
+        fprintf(stderr, "cannot read baseline (missing file or no results): %s\n", options.BaselinePath.c_str());
+        return 1;
+    }
+
+    FJobSystem jobs;
+    jobs.Start(options.Threads);
+    jobs.Deterministic = true;
+
+    FBenchRunner runner(options);
+    for (int numBalls : options.Sizes)
+    {
+        RunVectorBenchmarks(runner, numBalls, options.Seed);
+        RunShapeBenchmarks(runner, numBalls, options.Seed);
+        RunSpawnBenchmarks(runner, jobs, numBalls);
+        RunObstacleBenchmarks(runner, jobs, numBalls, options.Seed);
+        for (int distribution = 0; distribution < Radius_Count; distribution++)
+            RunWorldBenchmarks(runner, options, jobs, numBalls, distribution);
+    }
+
+    FILE* out = stdout;
+    if (!options.OutPath.empty())
+    {
+        out = fopen(options.OutPath.c_str(), "wb");
+        if (!out)
+        {
+            fprintf(stderr, "cannot write: %s\n", options.OutPath.c_str());
+            return 1;
+        }
+    }
+    WriteJson(out, options, jobs, runner.Results);
+    if (out != stdout) fclose(out);
+
+    int exitCode = 0;
+    if (!options.BaselinePath.empty() && CompareWithBaseline(baseline, runner.Results, options.Threshold) > 0)
+        exitCode = 2;
+
+    jobs.Shutdown();
+    return exitCode;
+}
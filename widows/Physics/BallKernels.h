@@ -0,0 +1,373 @@
+#pragma once
+
+// 여러 공을 한 번에 처리하는 SIMD 커널과 실행 중 CPU 기능 감지
+// 같은 연산을 스칼라/SSE(4개)/AVX(8개) 경로로 구현하고, 처음 호출할 때 CPU에 맞는 경로를 고른다.
+//
+// 오차: SIMD 경로는 FMA 없이 스칼라 식과 같은 순서로 곱하고 더하므로 보통 비트 단위로 같다.
+// 다만 컴파일러가 스칼라 식을 FMA로 합칠 수 있으므로, 위치/속도 성분마다
+// |SIMD - 스칼라| <= 1e-6 * max(1, |스칼라|) 를 보장 범위로 본다.
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define BALL_KERNELS_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#else
+#define BALL_KERNELS_X86 0
+#endif
+
+// GCC/Clang은 함수 단위로 AVX 코드 생성을 허용해야 한다 (MSVC는 플래그 없이 intrinsic 사용 가능)
+#if BALL_KERNELS_X86 && !defined(_MSC_VER)
+#define BALL_TARGET_AVX __attribute__((target("avx")))
+#else
+#define BALL_TARGET_AVX
+#endif
+
+#include <cmath>
+
+#include "Contact.h"
+
+enum class ESimdLevel
+{
+    Scalar,
+    SSE,
+    AVX,
+};
+
+inline const char* GetSimdLevelName(ESimdLevel level)
+{
+    switch (level)
+    {
+    case ESimdLevel::AVX: return "AVX";
+    case ESimdLevel::SSE: return "SSE";
+    default: return "Scalar";
+    }
+}
+
+// CPU와 OS가 지원하는 가장 넓은 SIMD 경로
+inline ESimdLevel DetectSimdLevel()
+{
+#if BALL_KERNELS_X86
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    const bool hasSSE2 = (info[3] & (1 << 26)) != 0;
+    const bool hasAVX = (info[2] & (1 << 28)) != 0;
+    const bool hasOSXSAVE = (info[2] & (1 << 27)) != 0;
+    // OS가 YMM 레지스터 상태를 저장해 주는지도 확인
+    const bool osSavesYmm = hasOSXSAVE && (_xgetbv(0) & 0x6) == 0x6;
+    if (hasAVX && osSavesYmm) return ESimdLevel::AVX;
+    if (hasSSE2) return ESimdLevel::SSE;
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx")) return ESimdLevel::AVX;
+    if (__builtin_cpu_supports("sse2")) return ESimdLevel::SSE;
+#endif
+#endif
+    return ESimdLevel::Scalar;
+}
+
+// 한 번 감지한 결과를 계속 사용
+inline ESimdLevel& ActiveSimdLevel()
+{
+    static ESimdLevel level = DetectSimdLevel();
+    return level;
+}
+
+// 공 배열 묶음 (FBallWorld의 배열을 그대로 가리킴)
+struct FBallArrays
+{
+    float* PosX;
+    float* PosY;
+    float* PosZ;
+    float* VelX;
+    float* VelY;
+    float* VelZ;
+    const float* Radius;
+};
+
+// ----- 적분 + 벽 반사 -----
+// 속도에 중력을 더하고, 위치를 옮긴 뒤 [-1, 1] 상자 벽에서 wallRestitution배 속도로 튕긴다.
+// z 벽도 항상 검사한다. 2D 모드의 공은 z = 0에 머물므로 z 벽에 닿을 일이 없다.
+
+// 공 하나 적분 (스칼라)
+inline void IntegrateBall(const FBallArrays& b, int i, float dt, float gravityY, float wallRestitution)
+{
+    b.VelY[i] += gravityY * dt;
+
+    b.PosX[i] += b.VelX[i] * dt;
+    b.PosY[i] += b.VelY[i] * dt;
+    b.PosZ[i] += b.VelZ[i] * dt;
+
+    const float lo = -1.0f + b.Radius[i];
+    const float hi = 1.0f - b.Radius[i];
+    if (b.PosX[i] <= lo) { b.PosX[i] = lo; b.VelX[i] = -b.VelX[i] * wallRestitution; }
+    if (b.PosX[i] >= hi) { b.PosX[i] = hi; b.VelX[i] = -b.VelX[i] * wallRestitution; }
+    if (b.PosY[i] <= lo) { b.PosY[i] = lo; b.VelY[i] = -b.VelY[i] * wallRestitution; }
+    if (b.PosY[i] >= hi) { b.PosY[i] = hi; b.VelY[i] = -b.VelY[i] * wallRestitution; }
+    if (b.PosZ[i] <= lo) { b.PosZ[i] = lo; b.VelZ[i] = -b.VelZ[i] * wallRestitution; }
+    if (b.PosZ[i] >= hi) { b.PosZ[i] = hi; b.VelZ[i] = -b.VelZ[i] * wallRestitution; }
+}
+
+inline void IntegrateBallsScalar(const FBallArrays& b, int begin, int end, float dt, float gravityY, float wallRestitution)
+{
+    for (int i = begin; i < end; i++)
+        IntegrateBall(b, i, dt, gravityY, wallRestitution);
+}
+
+// 인덱스 목록에 있는 공만 적분 (잠든 공을 건너뛸 때). 흩어진 접근이라 스칼라로만 처리한다
+inline void IntegrateBallsIndexed(const FBallArrays& b, const int* indices, int count, float dt, float gravityY, float wallRestitution)
+{
+    for (int k = 0; k < count; k++)
+        IntegrateBall(b, indices[k], dt, gravityY, wallRestitution);
+}
+
+#if BALL_KERNELS_X86
+
+inline __m128 SelectSSE(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// 벽 하나에 대한 분기 없는 반사: 조건이 맞는 칸만 위치를 벽에 붙이고 속도를 뒤집는다
+inline void BounceSSE(__m128& p, __m128& v, __m128 lo, __m128 hi, __m128 damping)
+{
+    const __m128 hitLo = _mm_cmple_ps(p, lo);
+    p = SelectSSE(hitLo, lo, p);
+    v = SelectSSE(hitLo, _mm_mul_ps(v, damping), v);
+
+    const __m128 hitHi = _mm_cmpge_ps(p, hi);
+    p = SelectSSE(hitHi, hi, p);
+    v = SelectSSE(hitHi, _mm_mul_ps(v, damping), v);
+}
+
+inline void IntegrateBallsSSE(const FBallArrays& b, int begin, int end, float dt, float gravityY, float wallRestitution)
+{
+    const __m128 vdt = _mm_set1_ps(dt);
+    const __m128 vgdt = _mm_set1_ps(gravityY * dt);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 damping = _mm_set1_ps(-wallRestitution);
+
+    int i = begin;
+    for (; i + 4 <= end; i += 4)
+    {
+        __m128 vx = _mm_loadu_ps(b.VelX + i);
+        __m128 vy = _mm_add_ps(_mm_loadu_ps(b.VelY + i), vgdt);
+        __m128 vz = _mm_loadu_ps(b.VelZ + i);
+
+        __m128 px = _mm_add_ps(_mm_loadu_ps(b.PosX + i), _mm_mul_ps(vx, vdt));
+        __m128 py = _mm_add_ps(_mm_loadu_ps(b.PosY + i), _mm_mul_ps(vy, vdt));
+        __m128 pz = _mm_add_ps(_mm_loadu_ps(b.PosZ + i), _mm_mul_ps(vz, vdt));
+
+        const __m128 r = _mm_loadu_ps(b.Radius + i);
+        const __m128 lo = _mm_sub_ps(r, one);
+        const __m128 hi = _mm_sub_ps(one, r);
+        BounceSSE(px, vx, lo, hi, damping);
+        BounceSSE(py, vy, lo, hi, damping);
+        BounceSSE(pz, vz, lo, hi, damping);
+
+        _mm_storeu_ps(b.PosX + i, px);
+        _mm_storeu_ps(b.PosY + i, py);
+        _mm_storeu_ps(b.PosZ + i, pz);
+        _mm_storeu_ps(b.VelX + i, vx);
+        _mm_storeu_ps(b.VelY + i, vy);
+        _mm_storeu_ps(b.VelZ + i, vz);
+    }
+    IntegrateBallsScalar(b, i, end, dt, gravityY, wallRestitution);
+}
+
+// blendv는 일부 CPU에서 느려서 and/andnot/or 조합으로 고른다
+BALL_TARGET_AVX inline __m256 SelectAVX(__m256 mask, __m256 a, __m256 b)
+{
+    return _mm256_or_ps(_mm256_and_ps(mask, a), _mm256_andnot_ps(mask, b));
+}
+
+BALL_TARGET_AVX inline void BounceAVX(__m256& p, __m256& v, __m256 lo, __m256 hi, __m256 damping)
+{
+    const __m256 hitLo = _mm256_cmp_ps(p, lo, _CMP_LE_OQ);
+    p = SelectAVX(hitLo, lo, p);
+    v = SelectAVX(hitLo, _mm256_mul_ps(v, damping), v);
+
+    const __m256 hitHi = _mm256_cmp_ps(p, hi, _CMP_GE_OQ);
+    p = SelectAVX(hitHi, hi, p);
+    v = SelectAVX(hitHi, _mm256_mul_ps(v, damping), v);
+}
+
+BALL_TARGET_AVX inline void IntegrateBallsAVX(const FBallArrays& b, int begin, int end, float dt, float gravityY, float wallRestitution)
+{
+    const __m256 vdt = _mm256_set1_ps(dt);
+    const __m256 vgdt = _mm256_set1_ps(gravityY * dt);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 damping = _mm256_set1_ps(-wallRestitution);
+
+    int i = begin;
+    for (; i + 8 <= end; i += 8)
+    {
+        __m256 vx = _mm256_loadu_ps(b.VelX + i);
+        __m256 vy = _mm256_add_ps(_mm256_loadu_ps(b.VelY + i), vgdt);
+        __m256 vz = _mm256_loadu_ps(b.VelZ + i);
+
+        __m256 px = _mm256_add_ps(_mm256_loadu_ps(b.PosX + i), _mm256_mul_ps(vx, vdt));
+        __m256 py = _mm256_add_ps(_mm256_loadu_ps(b.PosY + i), _mm256_mul_ps(vy, vdt));
+        __m256 pz = _mm256_add_ps(_mm256_loadu_ps(b.PosZ + i), _mm256_mul_ps(vz, vdt));
+
+        const __m256 r = _mm256_loadu_ps(b.Radius + i);
+        const __m256 lo = _mm256_sub_ps(r, one);
+        const __m256 hi = _mm256_sub_ps(one, r);
+        BounceAVX(px, vx, lo, hi, damping);
+        BounceAVX(py, vy, lo, hi, damping);
+        BounceAVX(pz, vz, lo, hi, damping);
+
+        _mm256_storeu_ps(b.PosX + i, px);
+        _mm256_storeu_ps(b.PosY + i, py);
+        _mm256_storeu_ps(b.PosZ + i, pz);
+        _mm256_storeu_ps(b.VelX + i, vx);
+        _mm256_storeu_ps(b.VelY + i, vy);
+        _mm256_storeu_ps(b.VelZ + i, vz);
+    }
+    IntegrateBallsScalar(b, i, end, dt, gravityY, wallRestitution);
+}
+
+#endif // BALL_KERNELS_X86
+
+// [begin, end) 범위의 공을 현재 SIMD 경로로 적분
+inline void IntegrateBalls(const FBallArrays& b, int begin, int end, float dt, float gravityY, float wallRestitution)
+{
+#if BALL_KERNELS_X86
+    switch (ActiveSimdLevel())
+    {
+    case ESimdLevel::AVX: IntegrateBallsAVX(b, begin, end, dt, gravityY, wallRestitution); return;
+    case ESimdLevel::SSE: IntegrateBallsSSE(b, begin, end, dt, gravityY, wallRestitution); return;
+    default: break;
+    }
+#endif
+    IntegrateBallsScalar(b, begin, end, dt, gravityY, wallRestitution);
+}
+
+// ----- 구 vs 구 좁은 단계 -----
+// 후보 쌍마다 거리를 재서 실제로 겹치는 쌍만 접촉 버퍼에 앞에서부터 채운다.
+// 출력 버퍼는 후보 쌍 개수만큼의 공간이 있어야 하며, 접촉 순서는 후보 쌍 순서를 그대로 따른다.
+
+inline int FindContactsScalar(const FBallArrays& b, const FCollisionPair* pairs, int begin, int end, FContact* outContacts)
+{
+    int numContacts = 0;
+    for (int k = begin; k < end; k++)
+    {
+        const int a = pairs[k].A;
+        const int c = pairs[k].B;
+        const float dx = b.PosX[c] - b.PosX[a];
+        const float dy = b.PosY[c] - b.PosY[a];
+        const float dz = b.PosZ[c] - b.PosZ[a];
+        const float distanceSq = dx * dx + dy * dy + dz * dz;
+        const float sumRadius = b.Radius[a] + b.Radius[c];
+
+        // 떨어져 있거나 중심이 거의 겹쳐 법선을 정할 수 없는 경우는 제외
+        if (distanceSq > sumRadius * sumRadius || distanceSq < 1e-6f) continue;
+
+        const float distance = sqrtf(distanceSq);
+        const float invDistance = 1.0f / distance;
+        outContacts[numContacts++] = { a, c, dx * invDistance, dy * invDistance, dz * invDistance, sumRadius - distance };
+    }
+    return numContacts;
+}
+
+#if BALL_KERNELS_X86
+
+// 마스크가 켜진 칸의 결과만 접촉 버퍼에 옮긴다
+inline int WriteContacts(const FCollisionPair* pairs, int mask, const float* nx, const float* ny, const float* nz, const float* penetration, FContact* outContacts)
+{
+    int numContacts = 0;
+    while (mask)
+    {
+        int lane = 0;
+        while (!(mask & (1 << lane))) lane++;
+        mask &= mask - 1;
+        outContacts[numContacts++] = { pairs[lane].A, pairs[lane].B, nx[lane], ny[lane], nz[lane], penetration[lane] };
+    }
+    return numContacts;
+}
+
+inline int FindContactsSSE(const FBallArrays& b, const FCollisionPair* pairs, int begin, int end, FContact* outContacts)
+{
+    const __m128 minDistanceSq = _mm_set1_ps(1e-6f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    alignas(16) float nx[4], ny[4], nz[4], penetration[4];
+
+    int numContacts = 0;
+    int k = begin;
+    for (; k + 4 <= end; k += 4)
+    {
+        const FCollisionPair* p = pairs + k;
+#define BALL_GATHER4(arr, idx) _mm_set_ps(arr[p[3].idx], arr[p[2].idx], arr[p[1].idx], arr[p[0].idx])
+        const __m128 dx = _mm_sub_ps(BALL_GATHER4(b.PosX, B), BALL_GATHER4(b.PosX, A));
+        const __m128 dy = _mm_sub_ps(BALL_GATHER4(b.PosY, B), BALL_GATHER4(b.PosY, A));
+        const __m128 dz = _mm_sub_ps(BALL_GATHER4(b.PosZ, B), BALL_GATHER4(b.PosZ, A));
+        const __m128 sumRadius = _mm_add_ps(BALL_GATHER4(b.Radius, A), BALL_GATHER4(b.Radius, B));
+#undef BALL_GATHER4
+
+        const __m128 distanceSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        const __m128 hit = _mm_and_ps(_mm_cmple_ps(distanceSq, _mm_mul_ps(sumRadius, sumRadius)), _mm_cmpge_ps(distanceSq, minDistanceSq));
+        const int mask = _mm_movemask_ps(hit);
+        if (!mask) continue;
+
+        const __m128 distance = _mm_sqrt_ps(distanceSq);
+        const __m128 invDistance = _mm_div_ps(one, distance);
+        _mm_store_ps(nx, _mm_mul_ps(dx, invDistance));
+        _mm_store_ps(ny, _mm_mul_ps(dy, invDistance));
+        _mm_store_ps(nz, _mm_mul_ps(dz, invDistance));
+        _mm_store_ps(penetration, _mm_sub_ps(sumRadius, distance));
+        numContacts += WriteContacts(p, mask, nx, ny, nz, penetration, outContacts + numContacts);
+    }
+    return numContacts + FindContactsScalar(b, pairs, k, end, outContacts + numContacts);
+}
+
+BALL_TARGET_AVX inline int FindContactsAVX(const FBallArrays& b, const FCollisionPair* pairs, int begin, int end, FContact* outContacts)
+{
+    const __m256 minDistanceSq = _mm256_set1_ps(1e-6f);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    alignas(32) float nx[8], ny[8], nz[8], penetration[8];
+
+    int numContacts = 0;
+    int k = begin;
+    for (; k + 8 <= end; k += 8)
+    {
+        const FCollisionPair* p = pairs + k;
+#define BALL_GATHER8(arr, idx) _mm256_set_ps(arr[p[7].idx], arr[p[6].idx], arr[p[5].idx], arr[p[4].idx], arr[p[3].idx], arr[p[2].idx], arr[p[1].idx], arr[p[0].idx])
+        const __m256 dx = _mm256_sub_ps(BALL_GATHER8(b.PosX, B), BALL_GATHER8(b.PosX, A));
+        const __m256 dy = _mm256_sub_ps(BALL_GATHER8(b.PosY, B), BALL_GATHER8(b.PosY, A));
+        const __m256 dz = _mm256_sub_ps(BALL_GATHER8(b.PosZ, B), BALL_GATHER8(b.PosZ, A));
+        const __m256 sumRadius = _mm256_add_ps(BALL_GATHER8(b.Radius, A), BALL_GATHER8(b.Radius, B));
+#undef BALL_GATHER8
+
+        const __m256 distanceSq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+        const __m256 hit = _mm256_and_ps(_mm256_cmp_ps(distanceSq, _mm256_mul_ps(sumRadius, sumRadius), _CMP_LE_OQ), _mm256_cmp_ps(distanceSq, minDistanceSq, _CMP_GE_OQ));
+        const int mask = _mm256_movemask_ps(hit);
+        if (!mask) continue;
+
+        const __m256 distance = _mm256_sqrt_ps(distanceSq);
+        const __m256 invDistance = _mm256_div_ps(one, distance);
+        _mm256_store_ps(nx, _mm256_mul_ps(dx, invDistance));
+        _mm256_store_ps(ny, _mm256_mul_ps(dy, invDistance));
+        _mm256_store_ps(nz, _mm256_mul_ps(dz, invDistance));
+        _mm256_store_ps(penetration, _mm256_sub_ps(sumRadius, distance));
+        numContacts += WriteContacts(p, mask, nx, ny, nz, penetration, outContacts + numContacts);
+    }
+    return numContacts + FindContactsScalar(b, pairs, k, end, outContacts + numContacts);
+}
+
+#endif // BALL_KERNELS_X86
+
+// [begin, end) 범위의 후보 쌍을 검사해 접촉 개수를 반환
+inline int FindContacts(const FBallArrays& b, const FCollisionPair* pairs, int begin, int end, FContact* outContacts)
+{
+#if BALL_KERNELS_X86
+    switch (ActiveSimdLevel())
+    {
+    case ESimdLevel::AVX: return FindContactsAVX(b, pairs, begin, end, outContacts);
+    case ESimdLevel::SSE: return FindContactsSSE(b, pairs, begin, end, outContacts);
+    default: break;
+    }
+#endif
+    return FindContactsScalar(b, pairs, begin, end, outContacts);
+}
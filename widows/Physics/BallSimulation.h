@@ -0,0 +1,562 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include <cstdlib>
+#include <cstdint>
+
+#include "Vector.h"
+#include "Random.h"
+#include "Contact.h"
+#include "JobSystem.h"
+#include "SpatialHash.h"
+#include "SweepAndPrune.h"
+#include "BallWorld.h"
+#include "BallSpawner.h"
+#include "StaticObstacles.h"
+#include "ContactSolver.h"
+#include "PositionSolver.h"
+#include "ContinuousCollision.h"
+#include "DynamicAabbTree.h"
+#include "MortonOrder.h"
+
+// 브로드페이즈 종류 (같은 장면에서 비교할 수 있도록 실행 중에 바꿀 수 있다)
+enum EBroadPhaseType
+{
+    BroadPhase_SpatialHash,
+    BroadPhase_SweepAndPrune,
+    BroadPhase_BruteForce,
+};
+
+// 접촉을 푸는 방식 (월드마다 고를 수 있다)
+enum ESolverType
+{
+    Solver_Impulse,          // 속도 반복(sequential impulse) + 겹침 80% 위치 보정 (FContactSolver)
+    Solver_XpbdGaussSeidel,  // 위치 기반 XPBD, 접촉 순서대로 직렬 반복 (FPositionSolver)
+    Solver_XpbdJacobi,       // 위치 기반 XPBD, 보정을 모아 평균 내는 병렬 반복
+};
+
+// 미리 준비된 장애물 배치
+enum EObstacleLayout
+{
+    ObstacleLayout_None,
+    ObstacleLayout_Pegs,   // 엇갈린 줄로 꽂힌 막대 수백 개 (골턴 보드)
+    ObstacleLayout_Funnel, // 삼각 기둥 두 개로 된 깔때기와 기울어진 상자, 모서리를 자르는 평면
+};
+
+// 미리 준비된 용기 모양 (상자 안에서 공이 있을 수 있는 영역)
+enum EContainerShape
+{
+    Container_Box,    // [-1, 1] 상자 벽만
+    Container_Circle, // 원 (3D 모드에서는 구)
+    Container_Star,   // 오목한 별 모양 다각형
+    Container_Mask,   // 그림(마스크)에서 구운 모양. 예제로 원 세 개를 통로로 이은 그림을 코드로 그린다
+};
+
+// 창이나 그래픽 API 없이 돌아가는 공 시뮬레이션
+// 공 상태, 브로드페이즈, 접촉 솔버, CCD를 묶어서 한 스텝씩 진행한다.
+// 렌더러와 UI(main.cpp)나 헤드리스 벤치마크가 같은 코드를 그대로 쓴다.
+class FBallSimulation
+{
+public:
+    // 모든 공의 상태 (SoA)
+    FBallWorld World;
+
+    bool EnableGravity = false;          // 중력 켜짐/꺼짐 상태
+    bool Enable3D = false;               // 3D 상자 모드 (z 방향으로도 뿌려서 움직인다. 바꿀 때는 SetEnable3D)
+    float GravityAcceleration = -9.8f;   // 중력 가속도 (Y 방향 아래로)
+    bool EnableCcd = true;               // 빠른 공의 터널링을 막는 연속 충돌 검사
+    int CollisionPasses = 2;             // 스텝마다 이산 충돌 처리 반복 횟수 (적응형 서브스텝을 쓰면 서브스텝마다 한 번)
+    int BroadPhaseType = BroadPhase_SpatialHash;
+    int SolverType = Solver_Impulse;     // XPBD는 (서브)스텝마다 접촉을 한 번 찾고 PositionSolver.Iterations번 풀며 CollisionPasses는 쓰지 않는다
+    int XpbdSubsteps = 4;                // XPBD의 최소 서브스텝 수 (위치 제약은 반복을 늘리는 것보다 스텝을 쪼개야 높은 더미에서 수렴한다)
+    float SpawnRadiusScale = 1.0f;       // 새로 만드는 공의 반지름 배율 (공을 많이 띄울 때 줄인다)
+    int ReorderInterval = 60;            // 이 스텝 수마다 공을 Morton 순서로 다시 배치 (0이면 안 함)
+    int ObstacleLayout = ObstacleLayout_None; // 바꿀 때는 SetObstacleLayout
+    int ContainerShape = Container_Box;       // 바꿀 때는 SetContainerShape
+    int ContainerResolution = 256;            // 용기 거리장의 축마다 격자점 수 (3D 구는 1/4)
+
+    // 적응형 서브스텝: 가장 빠른 공이 한 서브스텝 동안 가장 작은 반지름의 CflNumber배보다 멀리 가지 않도록
+    // 스텝마다 서브스텝 수를 고른다. 서브스텝마다 적분, CCD, 충돌 처리 한 번을 하므로
+    // 조용한 장면은 MinSubsteps번만, 격한 장면은 MaxSubsteps번까지 충돌을 푼다.
+    bool EnableAdaptiveSubsteps = false;
+    float CflNumber = 0.5f;
+    int MinSubsteps = 1;
+    int MaxSubsteps = 8;
+    int LastSubsteps = 1; // 마지막 Step에서 고른 서브스텝 수 (적응형이 꺼져 있으면 1)
+
+    // 공 생성과 제거에 쓰는 난수 (같은 seed면 같은 장면이 만들어진다)
+    FRandom Random;
+    FBallSpawner Spawner;
+
+    // 브로드페이즈 (충돌 후보 쌍 탐색) 및 접촉 버퍼
+    FSpatialHash BroadPhase;
+    FSweepAndPrune SweepAndPrune;
+    std::vector<FCollisionPair> CollisionPairs;
+    std::vector<FContact> Contacts;
+    int NumContacts = 0;
+    FContactSolver ContactSolver;
+    FPositionSolver PositionSolver;
+    FContinuousCollision ContinuousCollision;
+
+    // 움직이지 않는 장애물과 이번 패스의 공-장애물 접촉
+    FStaticObstacles Obstacles;
+    std::vector<FObstacleContact> ObstacleContacts;
+
+    // 공 위치에 대한 공간 질의용 트리 (쓰기 전에 Update를 불러야 한다)
+    FDynamicAabbTree BallTree;
+
+    explicit FBallSimulation(FJobSystem& jobs)
+        : Jobs(jobs)
+    {
+    }
+
+    // 공 수를 desiredCount에 맞춘다 (모자라면 빈자리에 뿌리고, 많으면 임의로 골라 제거)
+    // 제거는 바뀌는 공 수 k에 대해 O(k), 추가는 기존 공을 격자에 넣는 O(n)에 O(k)가 더해진다
+    void SetBallCount(int desiredCount)
+    {
+        if (desiredCount == World.Count) return;
+
+        if (desiredCount > World.Count)
+        {
+            // 기존 공과 겹치지 않는 자리에 끝에 붙인다 (용량은 두 배씩 늘어나 전체를 매번 복사하지 않는다)
+            // 반지름 0.035 ~ 0.335, 속도 성분 -0.666 ~ +0.666 정도
+            Spawner.Enable3D = Enable3D;
+            Spawner.Spawn(World, desiredCount - World.Count,
+                0.035f * SpawnRadiusScale, 0.335f * SpawnRadiusScale, 0.666f, Random, &Obstacles);
+        }
+        else
+        {
+            // 공 줄이기 (임의의 공을 골라 마지막 공과 자리를 바꿔 제거)
+            while (World.Count > 0 && World.Count > desiredCount)
+            {
+                World.RemoveAtSwap(Random.NextInt(World.Count));
+            }
+        }
+
+        // 공이 생기거나 사라지면 받치던 공이 없어질 수 있으므로 모두 깨운다
+        World.WakeAll();
+
+        // 인덱스가 바뀌었으므로 끝점 목록과 트리를 다시 만든다
+        SweepAndPrune.Invalidate();
+        BallTree.Invalidate();
+        bReorderPending = true;
+    }
+
+    // 2D/3D 모드를 바꾼다. 기존 공은 z = 0 평면에 있거나 상자 전체에 흩어져 있으므로 모두 지우고,
+    // 다음 SetBallCount에서 새 모드로 다시 뿌린다
+    void SetEnable3D(bool bEnable)
+    {
+        if (Enable3D == bEnable) return;
+        Enable3D = bEnable;
+        SetBallCount(0);
+        if (ContainerShape == Container_Circle)
+            BakeContainer(); // 원 용기는 모드에 따라 원기둥과 구가 다르다
+    }
+
+    // 용기 모양을 바꾸고 거리장을 다시 굽는다 (기존 공은 새 용기 밖에 있을 수 있으므로 모두 지운다)
+    void SetContainerShape(int shape)
+    {
+        if (ContainerShape == shape) return;
+        ContainerShape = shape;
+        SetBallCount(0);
+        BakeContainer();
+    }
+
+    // 그림 파일(PGM)에서 읽은 마스크를 용기로 쓴다. 읽지 못하면 false를 반환하고 용기를 바꾸지 않는다
+    bool LoadContainerMask(const char* path)
+    {
+        std::vector<uint8_t> mask;
+        int width = 0;
+        int height = 0;
+        if (!FSignedDistanceField::LoadPgm(path, mask, width, height)) return false; // 2픽셀보다 작은 그림도 여기서 걸러진다
+
+        ContainerShape = Container_Mask;
+        SetBallCount(0);
+        Obstacles.Container.BakeMask(mask.data(), width, height, 1.0f);
+        return true;
+    }
+
+    // 장애물 배치를 바꾸고 정적 BVH를 다시 만든다
+    // 기존 공은 새 장애물 안에 있을 수 있으므로 모두 지우고, 다음 SetBallCount에서 빈자리에 다시 뿌린다
+    void SetObstacleLayout(int layout)
+    {
+        if (ObstacleLayout == layout) return;
+        ObstacleLayout = layout;
+        SetBallCount(0);
+
+        Obstacles.Clear();
+        switch (layout)
+        {
+        case ObstacleLayout_Pegs:
+            // z 방향으로 상자를 가로지르는 가는 막대를 줄마다 반 칸씩 엇갈려 꽂는다
+            for (int row = 0; row < 13; row++)
+            {
+                const float y = 0.7f - 0.12f * row;
+                const float shift = (row & 1) ? 0.06f : 0.0f;
+                for (int column = 0; column < 16; column++)
+                {
+                    const float x = -0.93f + 0.12f * column + shift;
+                    Obstacles.AddCapsule(FVector(x, y, -1.0f), FVector(x, y, 1.0f), 0.015f);
+                }
+            }
+            break;
+
+        case ObstacleLayout_Funnel:
+        {
+            const FVector left[3] = { FVector(-1.0f, -0.2f), FVector(-0.15f, -0.2f), FVector(-1.0f, 0.4f) };
+            const FVector right[3] = { FVector(1.0f, -0.2f), FVector(1.0f, 0.4f), FVector(0.15f, -0.2f) };
+            Obstacles.AddPolygon(left, 3);
+            Obstacles.AddPolygon(right, 3);
+            Obstacles.AddBox(FVector(-0.35f, -0.55f), FVector(0.3f, 0.03f, 1.0f), -0.3f);
+            Obstacles.AddBox(FVector(0.35f, -0.8f), FVector(0.3f, 0.03f, 1.0f), 0.3f);
+            Obstacles.AddCapsule(FVector(-0.05f, 0.6f, -1.0f), FVector(0.05f, 0.6f, 1.0f), 0.05f);
+            Obstacles.AddPlane(FVector(-1.0f, 1.0f), -1.6f / sqrtf(2.0f)); // 오른쪽 아래 모서리
+            break;
+        }
+
+        default:
+            break;
+        }
+        Obstacles.Build();
+    }
+
+    // ContainerShape에 맞는 거리장을 굽는다
+    void BakeContainer()
+    {
+        FSignedDistanceField& container = Obstacles.Container;
+        switch (ContainerShape)
+        {
+        case Container_Circle:
+            if (Enable3D)
+                container.Bake(ContainerResolution / 4, ContainerResolution / 4, 1.0f, [](const FVector& p) { return FSignedDistanceField::DistanceToSphere(p, FVector(), 0.95f); });
+            else
+                container.Bake(ContainerResolution, 1, 1.0f, [](const FVector& p) { return FSignedDistanceField::DistanceToSphere(p, FVector(), 0.95f); });
+            break;
+
+        case Container_Star:
+        {
+            // 꼭짓점 5개짜리 별 (바깥 반지름 0.95, 안쪽 반지름 0.45)
+            FVector star[10];
+            for (int k = 0; k < 10; k++)
+            {
+                const float angle = 1.5707963f + 3.14159265f * k / 5.0f;
+                const float radius = (k & 1) ? 0.45f : 0.95f;
+                star[k] = FVector(radius * cosf(angle), radius * sinf(angle), 0.0f);
+            }
+            container.Bake(ContainerResolution, 1, 1.0f, [&star](const FVector& p) { return FSignedDistanceField::DistanceToPolygon(p, star, 10); });
+            break;
+        }
+
+        case Container_Mask:
+        {
+            // 원 세 개와 그 사이 통로를 칠한 그림 (파일에서 읽은 그림과 같은 경로로 굽는다)
+            const int size = ContainerResolution;
+            std::vector<uint8_t> mask((size_t)size * size, 0);
+            const float rooms[3][3] = { { -0.5f, 0.45f, 0.4f }, { 0.5f, 0.45f, 0.4f }, { 0.0f, -0.45f, 0.45f } };
+            for (int row = 0; row < size; row++)
+            {
+                for (int column = 0; column < size; column++)
+                {
+                    const float x = -1.0f + 2.0f * column / (size - 1);
+                    const float y = 1.0f - 2.0f * row / (size - 1);
+                    bool bFree = fabsf(y - 0.45f) < 0.12f && fabsf(x) < 0.6f; // 위쪽 두 방을 잇는 통로
+                    bFree = bFree || (fabsf(x) < 0.1f && y > -0.45f && y < 0.45f); // 아래 방으로 내려가는 통로
+                    for (int k = 0; k < 3 && !bFree; k++)
+                        bFree = (x - rooms[k][0]) * (x - rooms[k][0]) + (y - rooms[k][1]) * (y - rooms[k][1]) < rooms[k][2] * rooms[k][2];
+                    mask[(size_t)row * size + column] = bFree ? 1 : 0;
+                }
+            }
+            container.BakeMask(mask.data(), size, size, 1.0f);
+            break;
+        }
+
+        default:
+            container.Clear();
+            break;
+        }
+    }
+
+    // 물리 한 스텝: 적분 후 충돌 처리를 정해진 횟수만큼 반복 (적응형이면 서브스텝으로 나눠서 한 번씩)
+    // 스텝 시작 위치는 여기서 PrevPos에 저장하므로 (CCD와 렌더링 보간이 쓴다) 부르는 쪽에서 따로 저장하지 않는다
+    void Step(float dt)
+    {
+        // 이웃한 공이 메모리에서도 가깝도록 주기적으로 다시 배치
+        // (공을 새로 뿌린 직후에는 생성 순서가 무작위이므로 바로 한다)
+        if (ReorderInterval > 0 && (bReorderPending || ++StepsSinceReorder >= ReorderInterval))
+            ReorderBalls();
+
+        World.SavePreviousState();
+
+        const bool bXpbd = SolverType != Solver_Impulse;
+        if (!EnableAdaptiveSubsteps && !bXpbd)
+        {
+            LastSubsteps = 1;
+            Substep(dt, CollisionPasses);
+            return;
+        }
+
+        LastSubsteps = EnableAdaptiveSubsteps ? ChooseSubsteps(dt) : 1;
+        if (bXpbd)
+            LastSubsteps = std::max(LastSubsteps, XpbdSubsteps);
+        if (LastSubsteps == 1)
+        {
+            Substep(dt, 1);
+            return;
+        }
+
+        // CCD는 PrevPos를 서브스텝 시작 위치로 보므로 서브스텝마다 저장하고,
+        // 끝나면 렌더링 보간에 쓰는 스텝 시작 위치로 되돌린다
+        const int count = World.Count;
+        StepStartX.assign(World.PrevPosX, World.PrevPosX + count);
+        StepStartY.assign(World.PrevPosY, World.PrevPosY + count);
+        StepStartZ.assign(World.PrevPosZ, World.PrevPosZ + count);
+
+        const float subDt = dt / LastSubsteps;
+        for (int substep = 0; substep < LastSubsteps; substep++)
+        {
+            if (substep > 0)
+                World.SavePreviousState();
+            Substep(subDt, 1);
+        }
+
+        std::copy(StepStartX.begin(), StepStartX.end(), World.PrevPosX);
+        std::copy(StepStartY.begin(), StepStartY.end(), World.PrevPosY);
+        std::copy(StepStartZ.begin(), StepStartZ.end(), World.PrevPosZ);
+    }
+
+    // 이번 스텝의 서브스텝 수: 가장 빠른 공의 (중력을 더한) 이동 거리를 가장 작은 반지름의 CflNumber배로 나눈 값
+    int ChooseSubsteps(float dt)
+    {
+        const int count = World.Count;
+        const int grain = 4096;
+        ChunkMaxSpeedSq.resize(Jobs.GetNumChunks(count, grain));
+        ChunkMinRadius.resize(ChunkMaxSpeedSq.size());
+        Jobs.ParallelFor(count, grain, [this](int chunk, int begin, int end)
+        {
+            float maxSpeedSq = 0.0f;
+            float minRadius = FLT_MAX;
+            for (int i = begin; i < end; i++)
+            {
+                maxSpeedSq = std::max(maxSpeedSq, World.VelX[i] * World.VelX[i] + World.VelY[i] * World.VelY[i] + World.VelZ[i] * World.VelZ[i]);
+                minRadius = std::min(minRadius, World.Radius[i]);
+            }
+            ChunkMaxSpeedSq[chunk] = maxSpeedSq;
+            ChunkMinRadius[chunk] = minRadius;
+        });
+
+        float maxSpeedSq = 0.0f;
+        float minRadius = FLT_MAX;
+        for (size_t chunk = 0; chunk < ChunkMaxSpeedSq.size(); chunk++)
+        {
+            maxSpeedSq = std::max(maxSpeedSq, ChunkMaxSpeedSq[chunk]);
+            minRadius = std::min(minRadius, ChunkMinRadius[chunk]);
+        }
+        if (count == 0 || minRadius <= 0.0f) return MinSubsteps;
+
+        const float maxSpeed = sqrtf(maxSpeedSq) + (EnableGravity ? fabsf(GravityAcceleration) * dt : 0.0f);
+        const float ratio = maxSpeed * dt / (CflNumber * minRadius);
+        const int substeps = ratio < (float)MaxSubsteps ? (int)ceilf(ratio) : MaxSubsteps;
+        return std::min(std::max(substeps, MinSubsteps), std::max(MaxSubsteps, MinSubsteps));
+    }
+
+    // center에서 radius 안의 공을 바깥쪽으로 날려 보낸다 (가까울수록 세게)
+    void ApplyExplosion(const FVector& center, float radius, float speed)
+    {
+        BallTree.Update(World.PosX, World.PosY, World.PosZ, World.Radius, World.Count);
+        if ((int)QueryResults.size() < World.Count)
+            QueryResults.resize(World.Count);
+
+        const int numFound = BallTree.QueryRadius(center, radius, QueryResults.data(), (int)QueryResults.size());
+        for (int k = 0; k < numFound; k++)
+        {
+            const int i = QueryResults[k];
+            const FVector delta(World.PosX[i] - center.x, World.PosY[i] - center.y, World.PosZ[i] - center.z);
+            const float distance = sqrtf(delta.Dot(delta));
+            if (distance < 1e-6f) continue;
+
+            const float strength = speed * std::max(1.0f - distance / radius, 0.0f) / distance;
+            World.WakeUp(i);
+            World.VelX[i] += delta.x * strength;
+            World.VelY[i] += delta.y * strength;
+            World.VelZ[i] += delta.z * strength;
+        }
+    }
+
+    // 공을 위치의 Morton 코드 순서로 다시 배치한다 (공 인덱스를 들고 있는 브로드페이즈 상태는 다시 만든다)
+    // 접촉 캐시는 공 ID로 찾으므로 그대로 이어진다
+    void ReorderBalls()
+    {
+        StepsSinceReorder = 0;
+        bReorderPending = false;
+        if (World.Count < 2) return;
+
+        const std::vector<int>& order = MortonOrder.Compute(World.PosX, World.PosY, World.PosZ, World.Count);
+        World.Reorder(order.data());
+        SweepAndPrune.Invalidate();
+        BallTree.Invalidate();
+    }
+
+private:
+    // 비교용: 모든 쌍의 AABB를 직접 검사 (isQuery가 있으면 한쪽이라도 질의 공인 쌍만)
+    void FindPairsBruteForce(const uint8_t* isQuery, std::vector<FCollisionPair>& outPairs) const
+    {
+        outPairs.clear();
+        for (int i = 0; i < World.Count; i++)
+        {
+            for (int j = i + 1; j < World.Count; j++)
+            {
+                if (isQuery && !isQuery[i] && !isQuery[j]) continue;
+
+                const float reach = World.Radius[i] + World.Radius[j];
+                if (fabsf(World.PosX[j] - World.PosX[i]) > reach ||
+                    fabsf(World.PosY[j] - World.PosY[i]) > reach ||
+                    fabsf(World.PosZ[j] - World.PosZ[i]) > reach) continue;
+
+                outPairs.push_back({ i, j });
+            }
+        }
+    }
+
+    // 선택된 브로드페이즈로 AABB가 겹치는 쌍을 찾는다
+    // 잠든 공이 있으면 깨어 있는 공이 낀 쌍만 남겨서 잠든 공끼리의 쌍은 건너뛴다
+    void FindCollisionPairs(const std::vector<int>& awakeBalls)
+    {
+        const bool bAllAwake = World.NumSleeping == 0;
+        const uint8_t* isQuery = bAllAwake ? nullptr : World.Awake.data();
+
+        switch (BroadPhaseType)
+        {
+        case BroadPhase_SweepAndPrune:
+            if (bAllAwake)
+                SweepAndPrune.FindPairs(World.PosX, World.PosY, World.PosZ, World.Radius, World.Count, CollisionPairs);
+            else
+                SweepAndPrune.FindPairsFor(World.PosX, World.PosY, World.PosZ, World.Radius, World.Count, isQuery, CollisionPairs);
+            break;
+
+        case BroadPhase_BruteForce:
+            FindPairsBruteForce(isQuery, CollisionPairs);
+            break;
+
+        default:
+            if (bAllAwake)
+                BroadPhase.FindPairs(World.PosX, World.PosY, World.PosZ, World.Radius, World.Count, Jobs, CollisionPairs);
+            else
+                BroadPhase.FindPairsFor(World.PosX, World.PosY, World.PosZ, World.Radius, World.Count,
+                    awakeBalls.data(), (int)awakeBalls.size(), isQuery, Jobs, CollisionPairs);
+            break;
+        }
+    }
+
+    // 적분, CCD, 충돌 처리 passes번, 잠들기를 dt만큼 한 번 진행한다
+    void Substep(float dt, int passes)
+    {
+        if (SolverType != Solver_Impulse)
+        {
+            SubstepXpbd(dt);
+            return;
+        }
+
+        const float gravityY = EnableGravity ? GravityAcceleration : 0.0f;
+        World.Update(dt, gravityY, Jobs);
+
+        // 빠른 공만 지나간 경로로 검사해 서로 뚫고 지나가지 않게 한다
+        if (EnableCcd)
+            ContinuousCollision.Solve(World, dt, gravityY, Jobs);
+
+        // 충돌 처리 (브로드페이즈로 이웃한 공끼리만 검사)
+        ContactSolver.BeginStep();
+        for (int pass = 0; pass < passes; pass++)
+        {
+            ProcessCollisions(dt);
+        }
+
+        // 스텝 동안 거의 움직이지 않은 공을 재운다
+        World.UpdateSleep(dt);
+    }
+
+    // 위치 기반 서브스텝: 위치 예측 -> 접촉 찾기 -> 위치 제약 반복 -> 속도 다시 구하기
+    void SubstepXpbd(float dt)
+    {
+        PositionSolver.Jacobi = SolverType == Solver_XpbdJacobi;
+        const float gravityY = EnableGravity ? GravityAcceleration : 0.0f;
+        PositionSolver.Predict(World, dt, gravityY, Jobs);
+
+        if (EnableCcd)
+            ContinuousCollision.Solve(World, dt, gravityY, Jobs);
+
+        if (DetectCollisions(dt))
+        {
+            PositionSolver.Solve(World, CollisionPairs.data(), (int)CollisionPairs.size(), ObstacleContacts.data(), (int)ObstacleContacts.size(), dt, Jobs);
+        }
+        World.UpdateSleep(dt);
+    }
+
+    // 충돌 처리: 후보 쌍 탐색 -> 접촉 생성 -> 접촉 반응 순서로 나눠서 처리
+    void ProcessCollisions(float dt)
+    {
+        if (!DetectCollisions(dt)) return;
+
+        // 4. 반응: 공을 공유하지 않는 접촉끼리 배치로 묶어 병렬로 위치 보정과 튕김을 반복해서 푼다
+        //    (이전 스텝의 누적 충격량으로 시작하고, 충분히 수렴하면 일찍 끝냄)
+        ContactSolver.Solve(World, Contacts.data(), NumContacts, ObstacleContacts.data(), (int)ObstacleContacts.size(), dt, Jobs);
+    }
+
+    // 접촉 찾기 (깨어 있는 공이 없으면 false)
+    bool DetectCollisions(float dt)
+    {
+        // 1. 브로드페이즈: AABB가 겹치는 쌍만 고른다
+        const std::vector<int>& awakeBalls = World.GetAwakeBalls();
+        if (awakeBalls.empty())
+        {
+            CollisionPairs.clear();
+            NumContacts = 0;
+            ObstacleContacts.clear();
+            return false;
+        }
+        FindCollisionPairs(awakeBalls);
+
+        // 2. 좁은 단계: 여러 쌍을 SIMD로 한꺼번에 검사해 접촉 버퍼를 채운다
+        // 덩어리마다 자기 쌍 범위와 같은 위치에 접촉을 쓰고, 덩어리 순서대로 앞으로 당겨 붙인다
+        const int numPairs = (int)CollisionPairs.size();
+        const int pairGrain = 2048;
+        if ((int)Contacts.size() < numPairs)
+            Contacts.resize(numPairs);
+        ChunkContactCounts.resize(Jobs.GetNumChunks(numPairs, pairGrain));
+
+        const FBallArrays arrays = World.GetArrays();
+        Jobs.ParallelFor(numPairs, pairGrain, [this, &arrays](int chunk, int begin, int end)
+        {
+            ChunkContactCounts[chunk] = FindContacts(arrays, CollisionPairs.data(), begin, end, Contacts.data() + begin);
+        });
+
+        NumContacts = 0;
+        const int chunkSize = Jobs.GetChunkSize(numPairs, pairGrain);
+        for (int chunk = 0; chunk < (int)ChunkContactCounts.size(); chunk++)
+        {
+            const int count = ChunkContactCounts[chunk];
+            if (NumContacts != chunk * chunkSize)
+                std::copy(Contacts.begin() + chunk * chunkSize, Contacts.begin() + chunk * chunkSize + count, Contacts.begin() + NumContacts);
+            NumContacts += count;
+        }
+
+        // 장애물: 정적 BVH에서 AABB가 겹치는 장애물만 골라 검사한다
+        Obstacles.FindContacts(World, awakeBalls, Jobs, ObstacleContacts);
+
+        // 3. 빠르게 움직이는 공에 닿은 잠든 공을 깨운다 (깨어난 공은 이번 반응부터 움직인다)
+        World.PropagateWake(Contacts.data(), NumContacts, dt);
+        return true;
+    }
+
+    FJobSystem& Jobs;
+    FMortonOrder MortonOrder;
+    int StepsSinceReorder = 0;
+    bool bReorderPending = false; // 공 수가 바뀌어 다음 스텝에서 다시 배치해야 함
+    std::vector<int> ChunkContactCounts; // 좁은 단계 덩어리별 접촉 개수
+    std::vector<int> QueryResults;       // 질의 결과를 받을 버퍼 (공 수만큼 미리 확보해 재사용)
+    std::vector<float> ChunkMaxSpeedSq;  // 서브스텝 수를 고를 때 덩어리별 최대 속력 제곱과 최소 반지름
+    std::vector<float> ChunkMinRadius;
+    std::vector<float> StepStartX, StepStartY, StepStartZ; // 서브스텝으로 나눌 때 보관하는 스텝 시작 위치
+};
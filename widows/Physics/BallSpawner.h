@@ -0,0 +1,156 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+
+#include "Vector.h"
+#include "Random.h"
+#include "BallWorld.h"
+#include "StaticObstacles.h"
+
+// 공을 서로 겹치지 않게 한꺼번에 뿌리는 생성기 (격자로 가속한 Poisson-disk 다트 던지기)
+// 후보 위치마다 주변 3x3(3D에서는 3x3x3) 칸의 공하고만 거리를 재므로, 공 하나를 놓는 비용은 공 수와 무관하다.
+// 격자 칸은 가장 큰 지름보다 크게 잡아서, 반지름이 제각각이어도 겹칠 수 있는 공은 모두 주변 칸에 있다.
+// 반지름을 먼저 모두 뽑아 큰 공부터 놓는다 (작은 공은 큰 공 사이의 틈에도 들어가므로 나중에 놓아도 자리를 찾는다).
+class FBallSpawner
+{
+public:
+    int MaxAttempts = 500;      // 공 하나당 빈자리를 찾는 최대 시도 횟수 (대부분은 몇 번 만에 찾으므로 많이 채웠을 때만 이만큼 돈다)
+    float BoxHalfExtent = 1.0f; // 공이 놓일 상자 [-1, 1]
+    bool Enable3D = false;      // z 방향으로도 뿌린다 (꺼져 있으면 z = 0 평면에만)
+    int NumOverlapped = 0;      // 마지막 Spawn에서 빈자리를 못 찾아 (상자가 꽉 차서) 겹친 채로 놓은 공 수
+
+    // 공 count개를 기존 공과도 서로와도 겹치지 않게 추가한다
+    // 반지름은 [minRadius, maxRadius), 속도는 각 성분 [-maxSpeed, maxSpeed)에서 고른다 (2D 모드에서 z 성분은 0)
+    // obstacles가 있으면 장애물과 겹치는 자리도 피한다
+    void Spawn(FBallWorld& world, int count, float minRadius, float maxRadius, float maxSpeed, FRandom& random,
+        const FStaticObstacles* obstacles = nullptr)
+    {
+        NumOverlapped = 0;
+        if (count <= 0) return;
+
+        const int numExisting = world.Count;
+        world.Grow(numExisting + count);
+        BuildGrid(world, numExisting + count, maxRadius);
+
+        Radii.resize(count);
+        for (int k = 0; k < count; k++)
+            Radii[k] = random.NextRange(minRadius, maxRadius);
+        std::sort(Radii.begin(), Radii.end(), std::greater<float>());
+
+        int numFailedInRow = 0;
+        for (int k = 0; k < count; k++)
+        {
+            const float radius = Radii[k];
+            const float extent = std::max(BoxHalfExtent - radius, 0.0f);
+
+            const float extentZ = Enable3D ? extent : 0.0f;
+
+            float x = 0.0f;
+            float y = 0.0f;
+            float z = 0.0f;
+            bool bFound = false;
+            // 연달아 자리를 못 찾았으면 상자가 꽉 찬 것으로 보고, 나머지는 한 번 뽑은 자리에 그대로 놓는다
+            const bool bSaturated = numFailedInRow >= MaxFailuresInRow;
+            const int maxAttempts = bSaturated ? 1 : MaxAttempts;
+            for (int attempt = 0; attempt < maxAttempts && !bFound; attempt++)
+            {
+                x = random.NextRange(-extent, extent);
+                y = random.NextRange(-extent, extent);
+                z = Enable3D ? random.NextRange(-extentZ, extentZ) : 0.0f;
+                bFound = !bSaturated && !Overlaps(world, x, y, z, radius) &&
+                    !(obstacles && obstacles->Overlaps(USphere(FVector(x, y, z), radius)));
+            }
+            if (bFound)
+            {
+                numFailedInRow = 0;
+            }
+            else
+            {
+                numFailedInRow++;
+                NumOverlapped++;
+            }
+
+            const float vx = random.NextRange(-maxSpeed, maxSpeed);
+            const float vy = random.NextRange(-maxSpeed, maxSpeed);
+            const float vz = Enable3D ? random.NextRange(-maxSpeed, maxSpeed) : 0.0f;
+            const int i = world.Add(FVector(x, y, z), FVector(vx, vy, vz), radius);
+            Insert(i, x, y, z);
+        }
+    }
+
+private:
+    static const int MaxCellsPerAxis = 1024;
+    static const int MaxFailuresInRow = 64;
+
+    float CellSize = 1.0f;
+    int GridSize = 1;  // x, y 축 칸 수
+    int GridSizeZ = 1; // z 축 칸 수 (2D 모드에서는 1)
+    std::vector<int> CellHead; // 칸마다 첫 공 (-1이면 빈 칸)
+    std::vector<int> Next;     // 같은 칸의 다음 공
+    std::vector<float> Radii;  // 이번 Spawn에서 놓을 반지름 (큰 것부터)
+
+    // 기존 공을 모두 넣은 격자를 만든다 (칸 수는 공 수에 맞춰 제한)
+    void BuildGrid(const FBallWorld& world, int totalCount, float maxRadius)
+    {
+        float largest = maxRadius;
+        for (int i = 0; i < world.Count; i++)
+            largest = std::max(largest, world.Radius[i]);
+
+        const float boxSize = 2.0f * BoxHalfExtent;
+        // 칸 수가 공 수의 2배 정도를 넘지 않게 (3D에서는 세제곱근)
+        const float numCells = 2.0f * (float)totalCount;
+        const int maxCells = std::min((int)MaxCellsPerAxis, (int)(Enable3D ? cbrtf(numCells) : sqrtf(numCells)) + 1);
+        GridSize = std::max(1, std::min(maxCells, (int)(boxSize / std::max(2.0f * largest, 1e-6f))));
+        CellSize = boxSize / (float)GridSize;
+
+        GridSizeZ = Enable3D ? GridSize : 1;
+
+        CellHead.assign((size_t)GridSize * GridSize * GridSizeZ, -1);
+        Next.resize(totalCount);
+        for (int i = 0; i < world.Count; i++)
+            Insert(i, world.PosX[i], world.PosY[i], world.PosZ[i]);
+    }
+
+    // 상자 밖의 공은 가장자리 칸에 넣는다
+    int GetCellCoord(float value, int gridSize) const
+    {
+        const int cell = (int)floorf((value + BoxHalfExtent) / CellSize);
+        return std::min(std::max(cell, 0), gridSize - 1);
+    }
+
+    int GetCellIndex(int cx, int cy, int cz) const
+    {
+        return (cz * GridSize + cy) * GridSize + cx;
+    }
+
+    void Insert(int i, float x, float y, float z)
+    {
+        const int cell = GetCellIndex(GetCellCoord(x, GridSize), GetCellCoord(y, GridSize), GetCellCoord(z, GridSizeZ));
+        Next[i] = CellHead[cell];
+        CellHead[cell] = i;
+    }
+
+    bool Overlaps(const FBallWorld& world, float x, float y, float z, float radius) const
+    {
+        const int cx = GetCellCoord(x, GridSize);
+        const int cy = GetCellCoord(y, GridSize);
+        const int cz = GetCellCoord(z, GridSizeZ);
+        for (int gz = std::max(cz - 1, 0); gz <= std::min(cz + 1, GridSizeZ - 1); gz++)
+        for (int gy = std::max(cy - 1, 0); gy <= std::min(cy + 1, GridSize - 1); gy++)
+        for (int gx = std::max(cx - 1, 0); gx <= std::min(cx + 1, GridSize - 1); gx++)
+        {
+            for (int j = CellHead[GetCellIndex(gx, gy, gz)]; j != -1; j = Next[j])
+            {
+                const float dx = world.PosX[j] - x;
+                const float dy = world.PosY[j] - y;
+                const float dz = world.PosZ[j] - z;
+                const float reach = world.Radius[j] + radius;
+                if (dx * dx + dy * dy + dz * dz < reach * reach) return true;
+            }
+        }
+        return false;
+    }
+};
@@ -0,0 +1,427 @@
+#pragma once
+
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <new>
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+#include "Vector.h"
+#include "BallKernels.h"
+#include "JobSystem.h"
+
+// 모든 공의 상태를 성분별 연속 배열(SoA)로 보관하는 컨테이너
+// 공 하나를 new 하던 UBall 대신, 업데이트/충돌/렌더링 루프가 배열을 앞에서부터 순서대로 읽는다.
+class FBallWorld
+{
+public:
+    // SIMD 레지스터(AVX) 크기에 맞춘 배열 정렬
+    static const int Alignment = 32;
+
+    int Count = 0;    // 현재 공 개수
+    int Capacity = 0; // 배열에 할당된 칸 수
+
+    float* PosX = nullptr;
+    float* PosY = nullptr;
+    float* PosZ = nullptr;
+    float* VelX = nullptr;
+    float* VelY = nullptr;
+    float* VelZ = nullptr;
+    float* Radius = nullptr;
+    float* Mass = nullptr;
+    float* InvMass = nullptr;   // 1 / Mass, 잠든 공은 0 (충돌 반응에서 움직이지 않는 물체로 취급)
+    float* SleepTime = nullptr; // 기준 위치 근처에 머문 시간 (초)
+    float* SleepAnchorX = nullptr; // 잠들기 판정의 기준 위치 (멀리 벗어나면 다시 잡는다)
+    float* SleepAnchorY = nullptr;
+    float* SleepAnchorZ = nullptr;
+
+    // 직전 스텝의 위치 (렌더링 보간용)
+    float* PrevPosX = nullptr;
+    float* PrevPosY = nullptr;
+    float* PrevPosZ = nullptr;
+
+    // 공마다 고유한 ID (인덱스는 제거/재배치로 바뀌지만 ID는 유지된다)
+    std::vector<uint32_t> Ids;
+
+    // 재질 (월드마다 다르게 줄 수 있다)
+    float Restitution = 0.6f;     // 공끼리, 공과 장애물이 부딪힐 때의 반발 계수 (0~1 사이 값)
+    float WallRestitution = 0.8f; // 상자 벽에서 튕긴 뒤 남는 속도 비율
+
+    // 잠들기(sleeping): 일정 시간 거의 움직이지 않은 공은 적분과 잠든 공끼리의 충돌 검사를 건너뛴다
+    bool EnableSleeping = true;
+    float SleepVelocity = 0.02f; // TimeToSleep 동안의 평균 속도가 이보다 느리면 잠든다
+    float TimeToSleep = 0.5f;
+    float WakeVelocity = 0.5f;   // 이보다 빠르게 움직이는 공이 닿으면 잠든 공이 깨어난다 (더미 안의 떨림보다 충분히 크게)
+
+    std::vector<uint8_t> Awake; // 공마다 깨어 있으면 1
+    int NumSleeping = 0;
+
+    FBallWorld() = default;
+    FBallWorld(const FBallWorld&) = delete;
+    FBallWorld& operator=(const FBallWorld&) = delete;
+
+    ~FBallWorld()
+    {
+        FreeBlock(Block);
+    }
+
+    // 최소 newCapacity 칸을 확보한다 (기존 값은 유지)
+    void Reserve(int newCapacity)
+    {
+        if (newCapacity <= Capacity) return;
+
+        // 모든 배열을 한 블록에 두되, 배열 사이 간격을 4KB의 배수 + 64바이트로 맞춰
+        // 같은 인덱스의 주소가 4KB 단위로 겹치는 것(4K aliasing)을 피한다
+        const size_t stride = ((size_t)newCapacity + 1023) / 1024 * 1024 + 16;
+        float* newBlock = AllocateBlock(stride * NumArrays);
+        if (!newBlock) throw std::bad_alloc(); // 기존 배열은 그대로 둔다
+
+        size_t offset = 0;
+        ForEachArray([this, newBlock, stride, &offset](float*& arr)
+        {
+            float* newArr = newBlock + offset;
+            if (arr) memcpy(newArr, arr, sizeof(float) * Count);
+            arr = newArr;
+            offset += stride;
+        });
+
+        FreeBlock(Block);
+        Block = newBlock;
+        Capacity = newCapacity;
+        Ids.resize(newCapacity);
+        Awake.resize(newCapacity);
+    }
+
+    // 최소 minCapacity 칸이 되도록 용량을 두 배씩 늘린다
+    // 공 수를 조금씩 늘려도 재할당은 O(log n)번만 일어난다
+    void Grow(int minCapacity)
+    {
+        if (minCapacity <= Capacity) return;
+
+        int newCapacity = Capacity < 16 ? 16 : Capacity;
+        while (newCapacity < minCapacity)
+            newCapacity *= 2;
+        Reserve(newCapacity);
+    }
+
+    // 공 추가: 배열 끝에 붙이므로 O(1) (용량이 차면 두 배로 늘림). 추가된 인덱스를 반환
+    int Add(const FVector& location, const FVector& velocity, float radius)
+    {
+        if (Count == Capacity)
+            Grow(Count + 1);
+
+        const int i = Count++;
+        PosX[i] = location.x; PosY[i] = location.y; PosZ[i] = location.z;
+        VelX[i] = velocity.x; VelY[i] = velocity.y; VelZ[i] = velocity.z;
+        Radius[i] = radius;
+        Mass[i] = radius * radius; // 질량은 반지름^2에 비례
+        InvMass[i] = 1.0f / Mass[i];
+        SleepTime[i] = 0.0f;
+        SleepAnchorX[i] = location.x; SleepAnchorY[i] = location.y; SleepAnchorZ[i] = location.z;
+        PrevPosX[i] = location.x; PrevPosY[i] = location.y; PrevPosZ[i] = location.z;
+        Ids[i] = NextId++;
+        Awake[i] = 1;
+        bAwakeListDirty = true;
+        return i;
+    }
+
+    // 공 제거: 마지막 공을 빈 자리로 옮기므로 O(1)
+    void RemoveAtSwap(int index)
+    {
+        const int last = --Count;
+        if (index != last)
+        {
+            ForEachArray([index, last](float*& arr) { arr[index] = arr[last]; });
+            Ids[index] = Ids[last];
+            Awake[index] = Awake[last];
+        }
+        bAwakeListDirty = true;
+    }
+
+    // order[새 인덱스] = 옛 인덱스 순서로 모든 공을 다시 배치한다 (ID는 공을 따라 옮겨지므로 그대로 유효)
+    void Reorder(const int* order)
+    {
+        ReorderScratch.resize(Count);
+        float* scratch = ReorderScratch.data();
+        const int count = Count;
+        ForEachArray([order, scratch, count](float*& arr)
+        {
+            for (int i = 0; i < count; i++)
+                scratch[i] = arr[order[i]];
+            memcpy(arr, scratch, sizeof(float) * count);
+        });
+
+        ReorderIds.resize(Count);
+        ReorderAwake.resize(Count);
+        for (int i = 0; i < Count; i++)
+        {
+            ReorderIds[i] = Ids[order[i]];
+            ReorderAwake[i] = Awake[order[i]];
+        }
+        std::copy(ReorderIds.begin(), ReorderIds.end(), Ids.begin());
+        std::copy(ReorderAwake.begin(), ReorderAwake.end(), Awake.begin());
+        bAwakeListDirty = true;
+    }
+
+    void Clear()
+    {
+        Count = 0;
+        bAwakeListDirty = true;
+    }
+
+    void WakeUp(int i)
+    {
+        if (Awake[i]) return;
+        Awake[i] = 1;
+        InvMass[i] = 1.0f / Mass[i];
+        SleepTime[i] = 0.0f;
+        SleepAnchorX[i] = PosX[i]; SleepAnchorY[i] = PosY[i]; SleepAnchorZ[i] = PosZ[i];
+        bAwakeListDirty = true;
+    }
+
+    // 외부 변화(중력 전환, 공 추가/제거 등)가 있을 때 모든 공을 깨운다
+    void WakeAll()
+    {
+        for (int i = 0; i < Count; i++)
+            WakeUp(i);
+    }
+
+    // 깨어 있는 공이 닿은 잠든 공을 깨운다 (깨어 있는 공이 WakeVelocity보다 빠를 때만)
+    // 접촉을 따라 한 단계씩 퍼지므로, 충돌 패스가 반복될 때마다 더 멀리 전달된다
+    void PropagateWake(const FContact* contacts, int numContacts, float dt)
+    {
+        if (NumSleeping == 0) return;
+
+        const float wakeDistanceSq = WakeVelocity * dt * WakeVelocity * dt;
+        for (int c = 0; c < numContacts; c++)
+        {
+            const int a = contacts[c].A;
+            const int b = contacts[c].B;
+            if (Awake[a] == Awake[b]) continue;
+
+            const int mover = Awake[a] ? a : b;
+            if (GetStepMotionSq(mover) > wakeDistanceSq)
+                WakeUp(Awake[a] ? b : a);
+        }
+    }
+
+    // 스텝이 끝난 뒤 호출: 기준 위치에서 SleepVelocity * TimeToSleep 안에 머문 시간을 쌓고, 충분히 쌓이면 재운다
+    // 순간 속도 대신 구간 평균을 보므로, 바닥에서 제자리로 튀거나 더미 안에서 떨리는 공도 잠들 수 있다
+    void UpdateSleep(float dt)
+    {
+        if (!EnableSleeping)
+        {
+            if (NumSleeping > 0) WakeAll();
+            return;
+        }
+
+        const float tolerance = SleepVelocity * TimeToSleep;
+        const float toleranceSq = tolerance * tolerance;
+        for (int i = 0; i < Count; i++)
+        {
+            if (!Awake[i]) continue;
+
+            const float dx = PosX[i] - SleepAnchorX[i];
+            const float dy = PosY[i] - SleepAnchorY[i];
+            const float dz = PosZ[i] - SleepAnchorZ[i];
+            if (dx * dx + dy * dy + dz * dz > toleranceSq)
+            {
+                SleepAnchorX[i] = PosX[i]; SleepAnchorY[i] = PosY[i]; SleepAnchorZ[i] = PosZ[i];
+                SleepTime[i] = 0.0f;
+                continue;
+            }
+
+            SleepTime[i] += dt;
+            if (SleepTime[i] >= TimeToSleep)
+            {
+                Awake[i] = 0;
+                InvMass[i] = 0.0f;
+                VelX[i] = 0.0f; VelY[i] = 0.0f; VelZ[i] = 0.0f;
+                PrevPosX[i] = PosX[i]; PrevPosY[i] = PosY[i]; PrevPosZ[i] = PosZ[i];
+                bAwakeListDirty = true;
+            }
+        }
+    }
+
+    // 깨어 있는 공의 인덱스 (오름차순)
+    const std::vector<int>& GetAwakeBalls()
+    {
+        if (bAwakeListDirty)
+        {
+            AwakeBalls.clear();
+            for (int i = 0; i < Count; i++)
+                if (Awake[i]) AwakeBalls.push_back(i);
+            NumSleeping = Count - (int)AwakeBalls.size();
+            bAwakeListDirty = false;
+        }
+        return AwakeBalls;
+    }
+
+    FVector GetLocation(int i) const
+    {
+        return FVector(PosX[i], PosY[i], PosZ[i]);
+    }
+
+    // 직전 스텝 위치와 현재 위치 사이를 alpha(0 ~ 1)로 보간한 위치
+    FVector GetInterpolatedLocation(int i, float alpha) const
+    {
+        return FVector(
+            PrevPosX[i] + (PosX[i] - PrevPosX[i]) * alpha,
+            PrevPosY[i] + (PosY[i] - PrevPosY[i]) * alpha,
+            PrevPosZ[i] + (PosZ[i] - PrevPosZ[i]) * alpha);
+    }
+
+    // 모든 공 위치의 비트 패턴 해시 (같은 입력에서 결과가 바뀌었는지 확인용)
+    uint64_t HashPositions() const
+    {
+        uint64_t hash = 1469598103934665603ull; // FNV-1a
+        const float* arrays[3] = { PosX, PosY, PosZ };
+        for (const float* arr : arrays)
+        {
+            for (int i = 0; i < Count; i++)
+            {
+                uint32_t bits;
+                memcpy(&bits, &arr[i], sizeof(bits));
+                hash = (hash ^ bits) * 1099511628211ull;
+            }
+        }
+        return hash;
+    }
+
+    // 스텝을 진행하기 전에 현재 위치를 직전 위치로 저장
+    void SavePreviousState()
+    {
+        memcpy(PrevPosX, PosX, sizeof(float) * Count);
+        memcpy(PrevPosY, PosY, sizeof(float) * Count);
+        memcpy(PrevPosZ, PosZ, sizeof(float) * Count);
+    }
+
+    // SIMD 커널에 넘길 배열 묶음
+    FBallArrays GetArrays()
+    {
+        return { PosX, PosY, PosZ, VelX, VelY, VelZ, Radius };
+    }
+
+    // A: 모든 공의 물리 상태 업데이트 (gravityY가 0이면 중력 없음)
+    // 공끼리 서로 영향을 주지 않으므로 범위를 나눠 병렬로 적분한다
+    void Update(float dt, float gravityY, FJobSystem& jobs)
+    {
+        const FBallArrays arrays = GetArrays();
+        const std::vector<int>& awake = GetAwakeBalls();
+        if (NumSleeping == 0)
+        {
+            const float wallRestitution = WallRestitution;
+            jobs.ParallelFor(Count, IntegrateGrain, [&arrays, dt, gravityY, wallRestitution](int, int begin, int end)
+            {
+                IntegrateBalls(arrays, begin, end, dt, gravityY, wallRestitution);
+            });
+            return;
+        }
+
+        // 잠든 공이 있으면 깨어 있는 공만 골라서 적분
+        const int* indices = awake.data();
+        const float wallRestitution = WallRestitution;
+        jobs.ParallelFor((int)awake.size(), IntegrateGrain, [&arrays, indices, dt, gravityY, wallRestitution](int, int begin, int end)
+        {
+            IntegrateBallsIndexed(arrays, indices + begin, end - begin, dt, gravityY, wallRestitution);
+        });
+    }
+
+    // C: 접촉 하나에 대한 반응 (위치 보정 + 튕김)
+    void ResolveContact(const FContact& contact)
+    {
+        const int a = contact.A;
+        const int b = contact.B;
+        const FVector normal(contact.NormalX, contact.NormalY, contact.NormalZ);
+        const float invMassA = InvMass[a];
+        const float invMassB = InvMass[b];
+        const float totalInvMass = invMassA + invMassB;
+        if (totalInvMass == 0.0f) return; // 둘 다 잠든 공
+
+        // penetration 위치 보정
+        if (contact.Penetration > 0.001f)
+        {
+            // 각 공의 질량 비율에 따라 위치 보정 (잠든 공은 움직이지 않음)
+            float ratioA = invMassA / totalInvMass;
+            float ratioB = invMassB / totalInvMass;
+
+            FVector correction = normal * contact.Penetration * 0.8f;
+            PosX[a] -= correction.x * ratioA; PosY[a] -= correction.y * ratioA; PosZ[a] -= correction.z * ratioA;
+            PosX[b] += correction.x * ratioB; PosY[b] += correction.y * ratioB; PosZ[b] += correction.z * ratioB;
+        }
+
+        // impulse (튕김)
+        FVector relativeVelocity(VelX[b] - VelX[a], VelY[b] - VelY[a], VelZ[b] - VelZ[a]);
+        float velAlongNormal = relativeVelocity.Dot(normal);
+
+        // 충돌 후 튕김 처리
+        if (velAlongNormal < -0.01f)
+        {
+            float j = -(1.0f + Restitution) * velAlongNormal;
+            j /= totalInvMass;
+
+            FVector impulse = normal * j;
+            VelX[a] -= impulse.x * invMassA; VelY[a] -= impulse.y * invMassA; VelZ[a] -= impulse.z * invMassA;
+            VelX[b] += impulse.x * invMassB; VelY[b] += impulse.y * invMassB; VelZ[b] += impulse.z * invMassB;
+        }
+    }
+
+private:
+    static const int NumArrays = 16;
+    static const int IntegrateGrain = 4096; // 적분 잡 하나가 맡는 공 수
+    float* Block = nullptr; // 모든 배열이 들어 있는 메모리 블록
+    uint32_t NextId = 0;    // 다음에 추가될 공의 ID
+
+    std::vector<int> AwakeBalls;
+    bool bAwakeListDirty = true;
+
+    // Reorder에서 쓰는 임시 버퍼
+    std::vector<float> ReorderScratch;
+    std::vector<uint32_t> ReorderIds;
+    std::vector<uint8_t> ReorderAwake;
+
+    // 이번 스텝 동안 움직인 거리의 제곱
+    float GetStepMotionSq(int i) const
+    {
+        const float dx = PosX[i] - PrevPosX[i];
+        const float dy = PosY[i] - PrevPosY[i];
+        const float dz = PosZ[i] - PrevPosZ[i];
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    template <typename Func>
+    void ForEachArray(Func func)
+    {
+        func(PosX); func(PosY); func(PosZ);
+        func(VelX); func(VelY); func(VelZ);
+        func(Radius); func(Mass); func(InvMass);
+        func(SleepTime); func(SleepAnchorX); func(SleepAnchorY); func(SleepAnchorZ);
+        func(PrevPosX); func(PrevPosY); func(PrevPosZ);
+    }
+
+    // 실패하면 nullptr
+    static float* AllocateBlock(size_t count)
+    {
+#ifdef _MSC_VER
+        return (float*)_aligned_malloc(sizeof(float) * count, Alignment);
+#else
+        void* ptr = nullptr;
+        if (posix_memalign(&ptr, Alignment, sizeof(float) * count) != 0) return nullptr;
+        return (float*)ptr;
+#endif
+    }
+
+    static void FreeBlock(float* block)
+    {
+#ifdef _MSC_VER
+        _aligned_free(block);
+#else
+        free(block);
+#endif
+    }
+};
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+#include "JobSystem.h"
+#include "BallSimulation.h"
+
+// 모든 월드가 같이 읽는 설정 (월드를 처음 진행하기 전에 정하고, Step 중에는 바꾸지 않는다)
+struct FBatchConfig
+{
+    float StepTime = 1.0f / 60.0f;
+    bool Enable3D = false;
+    bool EnableCcd = true;
+    bool EnableSleeping = true;
+    bool EnableAdaptiveSubsteps = false;
+    int MaxSubsteps = 8;
+    int ReorderInterval = 60;
+    int BroadPhaseType = BroadPhase_SpatialHash;
+    int XpbdIterations = 4;   // XPBD 월드의 서브스텝마다 위치 반복 횟수
+    int XpbdSubsteps = 4;     // XPBD 월드의 최소 서브스텝 수
+    int ObstacleLayout = ObstacleLayout_None;
+    int ContainerShape = Container_Box;
+    int ContainerResolution = 256;
+    float SpawnRadiusScale = 1.0f;
+};
+
+// 월드마다 다르게 주는 값 (매개변수 스윕에서 바꾸는 것들)
+struct FWorldParams
+{
+    int NumBalls = 1000;
+    uint32_t Seed = 1;
+    int SolverType = Solver_Impulse;
+    int CollisionPasses = 2;
+    float Restitution = 0.6f;
+    float WallRestitution = 0.8f;
+    bool EnableGravity = true;
+    float GravityAcceleration = -9.8f;
+};
+
+// 월드 하나의 통계 (Step을 부를 때마다 누적된다)
+struct FWorldStats
+{
+    int NumSteps = 0;
+    double SetupSeconds = 0.0; // 거리장 굽기와 공 뿌리기
+    double StepSeconds = 0.0;  // 스텝에 쓴 시간 (이 월드를 맡은 스레드 기준)
+    uint64_t TotalPairs = 0;
+    uint64_t TotalContacts = 0;
+    uint64_t TotalAwake = 0;
+    uint64_t TotalSubsteps = 0;
+    int SpawnOverlaps = 0;
+
+    // 마지막 스텝 직후 상태
+    int NumBalls = 0;
+    int NumAwake = 0;
+    float MeanSpeed = 0.0f;
+    float MaxSpeed = 0.0f;
+    float MeanHeight = 0.0f; // 공 y 좌표의 평균 (더미가 얼마나 가라앉았는지)
+    uint64_t PositionHash = 0;
+
+    double GetNsPerBallStep() const { return NumSteps > 0 && NumBalls > 0 ? StepSeconds * 1e9 / ((double)NumBalls * NumSteps) : 0.0; }
+    double GetPairsPerStep() const { return NumSteps > 0 ? (double)TotalPairs / NumSteps : 0.0; }
+    double GetContactsPerStep() const { return NumSteps > 0 ? (double)TotalContacts / NumSteps : 0.0; }
+    double GetAwakePerStep() const { return NumSteps > 0 ? (double)TotalAwake / NumSteps : 0.0; }
+    double GetSubstepsPerStep() const { return NumSteps > 0 ? (double)TotalSubsteps / NumSteps : 0.0; }
+};
+
+// 서로 독립인 월드 K개를 한 프로세스에서 같이 진행한다 (반발 계수, 중력, 공 수 등의 매개변수 스윕용)
+// 월드 하나는 한 스레드가 통째로 맡고, 월드들을 잡으로 나눠 잡 시스템의 모든 코어에 흩는다.
+// 월드마다 자기 FBallSimulation과 (스레드를 띄우지 않는) 직렬 잡 시스템을 가지므로 월드끼리 공유하는 쓰기 상태가 없다.
+// 시뮬레이션은 그 월드를 처음 맡은 일꾼 스레드에서 만들어 메모리도 그 스레드가 처음 건드린다.
+class FBatchSimulation
+{
+public:
+    FBatchConfig Config;
+
+    explicit FBatchSimulation(FJobSystem& jobs)
+        : Jobs(jobs)
+    {
+    }
+
+    FBatchSimulation(const FBatchSimulation&) = delete;
+    FBatchSimulation& operator=(const FBatchSimulation&) = delete;
+
+    // 월드를 추가하고 번호를 반환한다 (공은 처음 Step에서 뿌린다)
+    int AddWorld(const FWorldParams& params)
+    {
+        Worlds.emplace_back(new FWorld());
+        Worlds.back()->Params = params;
+        return (int)Worlds.size() - 1;
+    }
+
+    void Clear()
+    {
+        Worlds.clear();
+    }
+
+    int GetNumWorlds() const { return (int)Worlds.size(); }
+    const FWorldParams& GetParams(int world) const { return Worlds[world]->Params; }
+    const FWorldStats& GetStats(int world) const { return Worlds[world]->Stats; }
+
+    // 아직 한 번도 진행하지 않은 월드는 nullptr
+    const FBallSimulation* GetSimulation(int world) const { return Worlds[world]->Simulation.get(); }
+
+    // 마지막 Step에 걸린 실제 시간
+    double GetLastSeconds() const { return LastSeconds; }
+
+    // 누적 통계를 비운다 (워밍업 스텝을 통계에서 뺄 때)
+    void ResetStats()
+    {
+        for (std::unique_ptr<FWorld>& world : Worlds)
+        {
+            FWorldStats& stats = world->Stats;
+            stats.NumSteps = 0;
+            stats.StepSeconds = 0.0;
+            stats.TotalPairs = 0;
+            stats.TotalContacts = 0;
+            stats.TotalAwake = 0;
+            stats.TotalSubsteps = 0;
+        }
+    }
+
+    // 모든 월드를 numSteps 스텝씩 진행하고 모두 끝나면 돌아온다
+    void Step(int numSteps)
+    {
+        // 공이 많은 월드부터 잡에 넣어서 마지막에 큰 월드 하나만 남아 코어가 노는 일을 줄인다
+        Order.resize(Worlds.size());
+        for (int i = 0; i < (int)Worlds.size(); i++)
+            Order[i] = i;
+        std::stable_sort(Order.begin(), Order.end(), [this](int l, int r)
+        {
+            return Worlds[l]->Params.NumBalls > Worlds[r]->Params.NumBalls;
+        });
+
+        const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        FJobCounter counter;
+        for (int i : Order)
+        {
+            FWorld* world = Worlds[i].get();
+            Jobs.Run([this, world, numSteps]() { RunWorld(*world, numSteps); }, &counter);
+        }
+        Jobs.Wait(counter);
+        LastSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    }
+
+private:
+    struct FWorld
+    {
+        FWorldParams Params;
+        FWorldStats Stats;
+        FJobSystem SerialJobs; // Start하지 않으므로 ParallelFor가 부른 스레드에서 바로 돈다
+        std::unique_ptr<FBallSimulation> Simulation;
+    };
+
+    // 일꾼 스레드에서 월드 하나를 만들고 (처음이면) numSteps 스텝 진행한다
+    void RunWorld(FWorld& world, int numSteps)
+    {
+        typedef std::chrono::steady_clock FClock;
+        const FBatchConfig& config = Config;
+        FWorldStats& stats = world.Stats;
+
+        if (!world.Simulation)
+        {
+            const FClock::time_point setupBegin = FClock::now();
+            world.Simulation.reset(new FBallSimulation(world.SerialJobs));
+            FBallSimulation& simulation = *world.Simulation;
+            simulation.Enable3D = config.Enable3D;
+            simulation.EnableCcd = config.EnableCcd;
+            simulation.World.EnableSleeping = config.EnableSleeping;
+            simulation.EnableAdaptiveSubsteps = config.EnableAdaptiveSubsteps;
+            simulation.MaxSubsteps = config.MaxSubsteps;
+            simulation.ReorderInterval = config.ReorderInterval;
+            simulation.BroadPhaseType = config.BroadPhaseType;
+            simulation.PositionSolver.Iterations = config.XpbdIterations;
+            simulation.XpbdSubsteps = config.XpbdSubsteps;
+            simulation.SpawnRadiusScale = config.SpawnRadiusScale;
+            simulation.ContainerResolution = config.ContainerResolution;
+            simulation.SetObstacleLayout(config.ObstacleLayout);
+            simulation.SetContainerShape(config.ContainerShape);
+
+            simulation.SolverType = world.Params.SolverType;
+            simulation.CollisionPasses = world.Params.CollisionPasses;
+            simulation.World.Restitution = world.Params.Restitution;
+            simulation.World.WallRestitution = world.Params.WallRestitution;
+            simulation.EnableGravity = world.Params.EnableGravity;
+            simulation.GravityAcceleration = world.Params.GravityAcceleration;
+            simulation.Random.Seed(world.Params.Seed);
+            simulation.SetBallCount(world.Params.NumBalls);
+
+            stats.SpawnOverlaps = simulation.Spawner.NumOverlapped;
+            stats.SetupSeconds = std::chrono::duration<double>(FClock::now() - setupBegin).count();
+        }
+
+        FBallSimulation& simulation = *world.Simulation;
+        const FClock::time_point begin = FClock::now();
+        for (int step = 0; step < numSteps; step++)
+        {
+            simulation.Step(config.StepTime);
+            stats.TotalPairs += simulation.CollisionPairs.size();
+            stats.TotalContacts += (uint64_t)simulation.NumContacts;
+            stats.TotalAwake += simulation.World.GetAwakeBalls().size();
+            stats.TotalSubsteps += (uint64_t)simulation.LastSubsteps;
+        }
+        stats.StepSeconds += std::chrono::duration<double>(FClock::now() - begin).count();
+        stats.NumSteps += numSteps;
+
+        // 마지막 상태 요약
+        const FBallWorld& balls = simulation.World;
+        double sumSpeed = 0.0;
+        double sumHeight = 0.0;
+        float maxSpeed = 0.0f;
+        for (int i = 0; i < balls.Count; i++)
+        {
+            const float speed = sqrtf(balls.VelX[i] * balls.VelX[i] + balls.VelY[i] * balls.VelY[i] + balls.VelZ[i] * balls.VelZ[i]);
+            sumSpeed += speed;
+            sumHeight += balls.PosY[i];
+            maxSpeed = std::max(maxSpeed, speed);
+        }
+        stats.NumBalls = balls.Count;
+        stats.NumAwake = (int)simulation.World.GetAwakeBalls().size();
+        stats.MeanSpeed = balls.Count > 0 ? (float)(sumSpeed / balls.Count) : 0.0f;
+        stats.MaxSpeed = maxSpeed;
+        stats.MeanHeight = balls.Count > 0 ? (float)(sumHeight / balls.Count) : 0.0f;
+        stats.PositionHash = balls.HashPositions();
+    }
+
+    FJobSystem& Jobs;
+    std::vector<std::unique_ptr<FWorld>> Worlds;
+    std::vector<int> Order;
+    double LastSeconds = 0.0;
+};
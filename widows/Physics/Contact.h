@@ -0,0 +1,30 @@
+#pragma once
+
+// 브로드페이즈가 만들어내는 충돌 후보 쌍 (항상 A < B)
+struct FCollisionPair
+{
+    int A;
+    int B;
+};
+
+// 좁은 단계가 만들어내는 접촉 정보 (법선은 A에서 B를 향함)
+struct FContact
+{
+    int A;
+    int B;
+    float NormalX;
+    float NormalY;
+    float NormalZ;
+    float Penetration;
+};
+
+// 공과 움직이지 않는 장애물의 접촉 (법선은 공에서 장애물을 향함)
+struct FObstacleContact
+{
+    int Ball;
+    int Obstacle;
+    float NormalX;
+    float NormalY;
+    float NormalZ;
+    float Penetration;
+};
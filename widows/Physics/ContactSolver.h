@@ -0,0 +1,539 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+
+#include "Contact.h"
+#include "BallWorld.h"
+#include "JobSystem.h"
+
+// 접촉 반응을 병렬로 푸는 반복(sequential impulse) 솔버
+// 접촉 하나는 두 공의 위치/속도를 모두 바꾸므로, 공을 공유하지 않는 접촉끼리 같은 색(배치)으로 묶는다 (그래프 색칠).
+// 같은 배치 안의 접촉은 서로 다른 공만 건드리므로 잠금 없이 병렬로 풀 수 있고,
+// 배치는 색 순서대로 하나씩 푼다. 색칠은 접촉 순서대로 직렬로 하므로 스레드 수와 관계없이 결과가 비트 단위로 같다.
+//
+// 접촉마다 누적 충격량을 공 ID 쌍으로 저장해 두었다가 다음 스텝의 시작값으로 쓴다 (warm start).
+// 쌓인 공처럼 매 스텝 같은 접촉이 유지되면 적은 반복으로도 바로 수렴한다.
+// 벽에 닿은 공도 움직이지 않는 상대(B = -1)와의 접촉으로 함께 풀어서, 쌓인 공의 무게가 벽까지 전달되게 한다.
+// 장애물 접촉도 같은 방식으로 넣되, 적분 단계에서 튕겨 주지 않으므로 공끼리처럼 반발 계수를 적용한다.
+class FContactSolver
+{
+public:
+    // 공 하나에 붙을 수 있는 색 수. 이를 넘는 접촉은 마지막에 직렬로 푼다
+    static const int MaxColors = 64;
+
+    int MaxIterations = 4;             // 속도 반복 최대 횟수
+    float ResidualThreshold = 1e-3f;   // 한 반복에서 가장 크게 바뀐 상대 속도가 이보다 작으면 멈춘다
+    float RestitutionThreshold = 0.25f; // 이보다 느리게 부딪히면 튕기지 않는다 (바닥에 쌓인 공의 떨림 방지)
+    float PositionCorrection = 0.2f;   // 한 번의 Solve에서 없앨 겹침의 비율 (split impulse)
+    float LinearSlop = 0.0005f;        // 이만큼의 겹침은 그대로 둔다 (접촉이 붙었다 떨어졌다 하지 않도록)
+
+    // 마지막 Solve의 통계
+    int NumBatches = 0;    // 배치 수 (직렬 배치 포함)
+    int NumIterations = 0; // 실제로 돈 반복 횟수
+    int NumWarmStarted = 0; // 캐시에서 충격량을 이어받은 접촉 수
+
+    // 한 스텝의 첫 Solve 전에 호출한다. 다음 Solve는 저장된 충격량을 속도에 먼저 적용한다
+    void BeginStep()
+    {
+        bApplyWarmStart = true;
+    }
+
+    // dt는 이번 (서브)스텝의 길이. 위치는 이미 적분된 뒤이므로 충격량이 바꾼 속도만큼 위치도 dt 동안 고쳐 준다
+    void Solve(FBallWorld& world, const FContact* contacts, int numContacts,
+        const FObstacleContact* obstacleContacts, int numObstacleContacts, float dt, FJobSystem& jobs)
+    {
+        BuildBatches(world, contacts, numContacts, obstacleContacts, numObstacleContacts);
+        FetchCachedImpulses(jobs);
+
+        // 1. 준비 (유효 질량, 목표 속도, 겹침을 풀 의사 속도)
+        const bool applyWarmStart = bApplyWarmStart;
+        bApplyWarmStart = false;
+        ForEachBatch(jobs, [this, &world, dt](FSolverContact& contact)
+        {
+            Prepare(world, contact, dt);
+            return 0.0f;
+        });
+
+        // 2. warm start: 목표 속도를 모두 정한 뒤에 적용해야 다른 접촉의 충격량이 튕김 판정에 섞이지 않는다
+        //    같은 스텝의 다음 패스라면 앞 패스의 충격량은 이미 속도에 들어 있으므로 적용하지 않고 따로 떼어 둔다.
+        //    이번 패스는 0에서 다시 누적하므로 앞 패스가 준 튕김을 되돌리지 않고, 다가오는 속도만 막는다
+        if (applyWarmStart)
+        {
+            ForEachBatch(jobs, [&world, dt](FSolverContact& contact)
+            {
+                if (contact.Impulse > 0.0f)
+                    ApplyImpulse(world, contact, contact.Impulse, dt);
+                return 0.0f;
+            });
+        }
+        else
+        {
+            for (FSolverContact& contact : Batched)
+            {
+                contact.AppliedImpulse = contact.Impulse;
+                contact.Impulse = 0.0f;
+            }
+        }
+
+        // 3. 속도 반복: 충격량 변화가 충분히 작아지면 일찍 끝낸다
+        NumIterations = 0;
+        while (NumIterations < MaxIterations)
+        {
+            NumIterations++;
+            const float residual = ForEachBatch(jobs, [&world, dt](FSolverContact& contact)
+            {
+                return SolveVelocity(world, contact, dt);
+            });
+            if (residual < ResidualThreshold) break;
+        }
+
+        // 4. 남은 겹침은 실제 속도와 따로 푼 의사 속도로 위치만 옮긴다 (split impulse)
+        //    위치를 직접 밀면 다음 스텝에 다시 파고들고, 속도에 넣으면 더미가 튀어 오른다
+        SolvePseudoVelocities(world, dt, jobs);
+
+        StoreCachedImpulses();
+    }
+
+private:
+    static const int SolveGrain = 512; // 반응 잡 하나가 맡는 접촉 수
+
+    // 솔버가 반복해서 쓰는 접촉 정보
+    struct FSolverContact
+    {
+        uint64_t Key;          // 접촉 종류와 공 ID 쌍 (MakeKey 참고)
+        int A;
+        int B;                 // 벽이면 -1
+        float NormalX;
+        float NormalY;
+        float NormalZ;
+        float Penetration;
+        float EffectiveMass;   // 1 / (1/mA + 1/mB), 벽이나 잠든 공이면 그 항은 0
+        float TargetVelocity;  // 풀고 나서 법선 방향 상대 속도가 이 이상이 되도록
+        float Impulse;         // 누적 충격량 (항상 0 이상)
+        float AppliedImpulse;  // 같은 스텝의 앞 패스에서 이미 준 충격량 (캐시에는 Impulse와 더해 저장)
+        float PositionBias;    // 겹침을 풀기 위한 법선 방향 의사 속도 목표
+        float PseudoImpulse;   // 의사 속도의 누적 충격량 (항상 0 이상)
+        bool bCached;          // 캐시에서 이어받은 접촉인지
+        bool bBounce;          // 솔버에서 튕김을 줄지 (상자 벽은 적분 단계에서 이미 튕김)
+    };
+
+    // 이전 Solve에서 저장한 누적 충격량
+    struct FCachedImpulse
+    {
+        uint64_t Key;
+        float Impulse;
+    };
+
+    // 벽 접촉 판정 여유 거리
+    static constexpr float WallSlop = 0.001f;
+
+    // 키의 맨 위 2비트는 접촉 종류, 그 아래로 31비트씩 두 ID를 넣는다.
+    // 종류가 다르면 키가 절대 겹치지 않으므로 공 ID는 2^31보다 작아야 한다
+    static const uint64_t BallPairTag = 0;
+    static const uint64_t WallTag = 1;
+    static const uint64_t ObstacleTag = 2;
+    static const uint32_t MaxKeyId = 0x7FFFFFFFu;
+
+    static uint64_t PackKey(uint64_t tag, uint32_t high, uint32_t low)
+    {
+        assert(high <= MaxKeyId && low <= MaxKeyId);
+        return (tag << 62) | ((uint64_t)high << 31) | low;
+    }
+
+    static uint64_t MakeKey(uint32_t idA, uint32_t idB)
+    {
+        if (idA > idB) std::swap(idA, idB);
+        return PackKey(BallPairTag, idA, idB);
+    }
+
+    // 벽 접촉의 키: 공 ID와 벽 번호
+    static uint64_t MakeWallKey(uint32_t id, int wall)
+    {
+        return PackKey(WallTag, id, (uint32_t)wall);
+    }
+
+    // 장애물 접촉의 키: 공 ID와 장애물 번호
+    static uint64_t MakeObstacleKey(uint32_t id, int obstacle)
+    {
+        return PackKey(ObstacleTag, id, (uint32_t)obstacle);
+    }
+
+    // 적분 커널과 같은 [-1, 1] 상자의 벽에 닿아 있는 공을 벽 접촉으로 만든다 (2D 모드의 공은 z 벽에 닿지 않는다)
+    void FindWallContacts(const FBallWorld& world)
+    {
+        WallContacts.clear();
+        for (int i = 0; i < world.Count; i++)
+        {
+            if (!world.Awake[i]) continue; // 잠든 공은 움직이지 않으므로 벽에 밀릴 일이 없다
+
+            const float r = world.Radius[i];
+            const float limit = 1.0f - r - WallSlop;
+            const float px = world.PosX[i];
+            const float py = world.PosY[i];
+            const float pz = world.PosZ[i];
+            if (px < -limit) AddWallContact(world, i, 0, -1.0f, 0.0f, 0.0f, r - (px + 1.0f));
+            if (px > limit)  AddWallContact(world, i, 1, 1.0f, 0.0f, 0.0f, r - (1.0f - px));
+            if (py < -limit) AddWallContact(world, i, 2, 0.0f, -1.0f, 0.0f, r - (py + 1.0f));
+            if (py > limit)  AddWallContact(world, i, 3, 0.0f, 1.0f, 0.0f, r - (1.0f - py));
+            if (pz < -limit) AddWallContact(world, i, 4, 0.0f, 0.0f, -1.0f, r - (pz + 1.0f));
+            if (pz > limit)  AddWallContact(world, i, 5, 0.0f, 0.0f, 1.0f, r - (1.0f - pz));
+        }
+    }
+
+    void AddWallContact(const FBallWorld& world, int i, int wall, float nx, float ny, float nz, float penetration)
+    {
+        FSolverContact contact;
+        contact.Key = MakeWallKey(world.Ids[i], wall);
+        contact.A = i;
+        contact.B = -1;
+        contact.NormalX = nx;
+        contact.NormalY = ny;
+        contact.NormalZ = nz;
+        contact.Penetration = penetration;
+        contact.Impulse = 0.0f;
+        contact.AppliedImpulse = 0.0f;
+        contact.bCached = false;
+        contact.bBounce = false;
+        WallContacts.push_back(contact);
+    }
+
+    // 접촉마다 두 공이 아직 쓰지 않은 가장 작은 색을 주고, 색 순서대로 접촉을 다시 늘어놓는다
+    void BuildBatches(const FBallWorld& world, const FContact* contacts, int numContacts,
+        const FObstacleContact* obstacleContacts, int numObstacleContacts)
+    {
+        FindWallContacts(world);
+
+        // 공끼리 접촉 뒤에 벽 접촉, 장애물 접촉을 이어 붙인 순서로 색칠한다
+        const int numBallContacts = numContacts;
+        const int numWallContacts = (int)WallContacts.size();
+        const int numTotal = numBallContacts + numWallContacts + numObstacleContacts;
+        Unsorted.resize(numTotal);
+        for (int c = 0; c < numBallContacts; c++)
+        {
+            const FContact& src = contacts[c];
+            FSolverContact& dst = Unsorted[c];
+            dst.Key = MakeKey(world.Ids[src.A], world.Ids[src.B]);
+            dst.A = src.A;
+            dst.B = src.B;
+            dst.NormalX = src.NormalX;
+            dst.NormalY = src.NormalY;
+            dst.NormalZ = src.NormalZ;
+            dst.Penetration = src.Penetration;
+            dst.Impulse = 0.0f;
+            dst.AppliedImpulse = 0.0f;
+            dst.bCached = false;
+            dst.bBounce = true;
+        }
+        std::copy(WallContacts.begin(), WallContacts.end(), Unsorted.begin() + numBallContacts);
+        for (int c = 0; c < numObstacleContacts; c++)
+        {
+            const FObstacleContact& src = obstacleContacts[c];
+            FSolverContact& dst = Unsorted[numBallContacts + numWallContacts + c];
+            dst.Key = MakeObstacleKey(world.Ids[src.Ball], src.Obstacle);
+            dst.A = src.Ball;
+            dst.B = -1;
+            dst.NormalX = src.NormalX;
+            dst.NormalY = src.NormalY;
+            dst.NormalZ = src.NormalZ;
+            dst.Penetration = src.Penetration;
+            dst.Impulse = 0.0f;
+            dst.AppliedImpulse = 0.0f;
+            dst.bCached = false;
+            dst.bBounce = true;
+        }
+
+        BallColors.assign(world.Count, 0);
+        ContactColor.resize(numTotal);
+        BatchStart.assign(MaxColors + 2, 0);
+
+        for (int c = 0; c < numTotal; c++)
+        {
+            const int a = Unsorted[c].A;
+            const int b = Unsorted[c].B;
+            // 잠든 공은 속도가 바뀌지 않으므로 색을 나눠 쓸 필요가 없다
+            const bool dynamicA = world.Awake[a] != 0;
+            const bool dynamicB = b >= 0 && world.Awake[b] != 0;
+            const uint64_t used = (dynamicA ? BallColors[a] : 0) | (dynamicB ? BallColors[b] : 0);
+
+            int color = 0;
+            while (color < MaxColors && (used & (1ull << color))) color++;
+            if (color < MaxColors)
+            {
+                if (dynamicA) BallColors[a] |= 1ull << color;
+                if (dynamicB) BallColors[b] |= 1ull << color;
+            }
+
+            ContactColor[c] = color;
+            BatchStart[color + 1]++;
+        }
+
+        NumBatches = 0;
+        for (int color = 0; color <= MaxColors; color++)
+        {
+            if (BatchStart[color + 1] > 0) NumBatches++;
+            BatchStart[color + 1] += BatchStart[color];
+        }
+
+        // 같은 색 안에서는 원래 접촉 순서를 유지 (counting sort)
+        Batched.resize(numTotal);
+        BatchFill.assign(BatchStart.begin(), BatchStart.end() - 1);
+        for (int c = 0; c < numTotal; c++)
+            Batched[BatchFill[ContactColor[c]]++] = Unsorted[c];
+    }
+
+    // 색 순서대로 배치마다 func를 병렬로 적용하고, func가 돌려준 값의 최댓값을 반환한다
+    template <typename Func>
+    float ForEachBatch(FJobSystem& jobs, const Func& func)
+    {
+        float residual = 0.0f;
+        for (int color = 0; color < MaxColors; color++)
+        {
+            const int begin = BatchStart[color];
+            const int count = BatchStart[color + 1] - begin;
+            if (count == 0) continue;
+
+            ChunkResidual.assign(jobs.GetNumChunks(count, SolveGrain), 0.0f);
+            FSolverContact* batch = Batched.data() + begin;
+            jobs.ParallelFor(count, SolveGrain, [this, batch, &func](int chunk, int b, int e)
+            {
+                float chunkResidual = 0.0f;
+                for (int c = b; c < e; c++)
+                    chunkResidual = std::max(chunkResidual, func(batch[c]));
+                ChunkResidual[chunk] = chunkResidual;
+            });
+            for (float r : ChunkResidual)
+                residual = std::max(residual, r);
+        }
+
+        // 색이 모자란 접촉은 순서대로 직렬 처리
+        for (int c = BatchStart[MaxColors]; c < BatchStart[MaxColors + 1]; c++)
+            residual = std::max(residual, func(Batched[c]));
+        return residual;
+    }
+
+    // 접촉마다 캐시에서 같은 공 쌍의 누적 충격량을 찾는다 (캐시는 Key로 정렬되어 있음)
+    void FetchCachedImpulses(FJobSystem& jobs)
+    {
+        if (Cache.empty())
+        {
+            NumWarmStarted = 0;
+            return;
+        }
+
+        const int numContacts = (int)Batched.size();
+        ChunkWarmStarted.assign(jobs.GetNumChunks(numContacts, SolveGrain), 0);
+        jobs.ParallelFor(numContacts, SolveGrain, [this](int chunk, int begin, int end)
+        {
+            int found = 0;
+            for (int c = begin; c < end; c++)
+            {
+                const uint64_t key = Batched[c].Key;
+                auto it = std::lower_bound(Cache.begin(), Cache.end(), key,
+                    [](const FCachedImpulse& cached, uint64_t k) { return cached.Key < k; });
+                if (it != Cache.end() && it->Key == key)
+                {
+                    Batched[c].Impulse = it->Impulse;
+                    Batched[c].bCached = true;
+                    found++;
+                }
+            }
+            ChunkWarmStarted[chunk] = found;
+        });
+
+        NumWarmStarted = 0;
+        for (int found : ChunkWarmStarted)
+            NumWarmStarted += found;
+    }
+
+    // 이번 누적 충격량을 Key 순서로 저장 (다음 Solve에서 이진 탐색)
+    void StoreCachedImpulses()
+    {
+        Cache.resize(Batched.size());
+        for (size_t c = 0; c < Batched.size(); c++)
+            Cache[c] = { Batched[c].Key, Batched[c].Impulse + Batched[c].AppliedImpulse };
+        std::sort(Cache.begin(), Cache.end(), [](const FCachedImpulse& l, const FCachedImpulse& r) { return l.Key < r.Key; });
+    }
+
+    // 잠든 공(역질량 0)은 색을 나눌 때 빠지므로 같은 배치의 다른 접촉과 공유될 수 있다.
+    // 더하는 값이 0이어도 쓰지 않아야 병렬 덩어리끼리 같은 공을 동시에 쓰지 않는다.
+    // 속도가 바뀐 만큼 위치도 dt 동안 옮겨서, 충격량을 적분 전에 준 것과 같게 만든다
+    // (그러지 않으면 쌓인 공이 매 스텝 중력 때문에 g * dt^2씩 서로 파고든다)
+    static void ApplyImpulse(FBallWorld& world, const FSolverContact& contact, float impulse, float dt)
+    {
+        const int a = contact.A;
+        const int b = contact.B;
+        const float ix = contact.NormalX * impulse;
+        const float iy = contact.NormalY * impulse;
+        const float iz = contact.NormalZ * impulse;
+
+        const float invMassA = world.InvMass[a];
+        if (invMassA != 0.0f)
+        {
+            world.VelX[a] -= ix * invMassA; world.VelY[a] -= iy * invMassA; world.VelZ[a] -= iz * invMassA;
+            const float moveA = invMassA * dt;
+            world.PosX[a] -= ix * moveA; world.PosY[a] -= iy * moveA; world.PosZ[a] -= iz * moveA;
+        }
+        if (b < 0) return;
+
+        const float invMassB = world.InvMass[b];
+        if (invMassB != 0.0f)
+        {
+            world.VelX[b] += ix * invMassB; world.VelY[b] += iy * invMassB; world.VelZ[b] += iz * invMassB;
+            const float moveB = invMassB * dt;
+            world.PosX[b] += ix * moveB; world.PosY[b] += iy * moveB; world.PosZ[b] += iz * moveB;
+        }
+    }
+
+    // 법선 방향 상대 속도 (B의 속도 - A의 속도, 벽은 속도 0)
+    static float NormalVelocity(const FBallWorld& world, const FSolverContact& contact)
+    {
+        const int a = contact.A;
+        const int b = contact.B;
+        float vx = -world.VelX[a];
+        float vy = -world.VelY[a];
+        float vz = -world.VelZ[a];
+        if (b >= 0)
+        {
+            vx += world.VelX[b];
+            vy += world.VelY[b];
+            vz += world.VelZ[b];
+        }
+        return vx * contact.NormalX + vy * contact.NormalY + vz * contact.NormalZ;
+    }
+
+    void Prepare(const FBallWorld& world, FSolverContact& contact, float dt) const
+    {
+        const int a = contact.A;
+        const int b = contact.B;
+
+        // 슬롭을 넘는 겹침의 PositionCorrection만큼을 이번 dt 동안 벌린다
+        contact.PositionBias = std::max(contact.Penetration - LinearSlop, 0.0f) * PositionCorrection / dt;
+        contact.PseudoImpulse = 0.0f;
+
+        if (b < 0)
+        {
+            // 벽이나 장애물: 공만 움직인다
+            contact.EffectiveMass = world.Mass[a];
+
+            // 상자 벽의 튕김은 적분 단계에서 이미 처리했으므로 벽 안으로 들어가는 속도만 막는다
+            if (!contact.bBounce)
+            {
+                contact.TargetVelocity = 0.0f;
+                return;
+            }
+        }
+        else
+        {
+            // 잠든 공은 역질량이 0이라 움직이지 않는 벽처럼 다뤄진다
+            contact.EffectiveMass = 1.0f / (world.InvMass[a] + world.InvMass[b]);
+        }
+
+        // 튕김은 새로 생긴 접촉이 충분히 빠르게 부딪힐 때만 준다.
+        // 캐시에 있던 접촉(이전 스텝부터 이어졌거나 같은 스텝의 앞 패스에서 이미 튕긴 접촉)은 목표 속도가 0이다.
+        // 다음 패스마다 튕김을 다시 주면 더미 전체로 퍼지면서 패스 수만큼 에너지가 늘어난다.
+        if (!contact.bCached)
+        {
+            const float velAlongNormal = NormalVelocity(world, contact);
+            contact.TargetVelocity = velAlongNormal < -RestitutionThreshold ? -world.Restitution * velAlongNormal : 0.0f;
+        }
+        else
+        {
+            contact.TargetVelocity = 0.0f;
+        }
+    }
+
+    // 누적 충격량이 0 이상이 되도록 자르면서 목표 속도에 맞춘다. 이번에 바뀐 상대 속도 크기를 반환
+    static float SolveVelocity(FBallWorld& world, FSolverContact& contact, float dt)
+    {
+        const float velAlongNormal = NormalVelocity(world, contact);
+        const float lambda = contact.EffectiveMass * (contact.TargetVelocity - velAlongNormal);
+
+        const float oldImpulse = contact.Impulse;
+        contact.Impulse = std::max(oldImpulse + lambda, 0.0f);
+        const float delta = contact.Impulse - oldImpulse;
+        if (delta != 0.0f)
+            ApplyImpulse(world, contact, delta, dt);
+
+        return fabsf(delta) / contact.EffectiveMass;
+    }
+
+    // 의사 속도로 겹침을 푼다. 반복 방식은 속도 반복과 같고, 끝나면 의사 속도 * dt만큼 위치만 옮기고 버린다
+    void SolvePseudoVelocities(FBallWorld& world, float dt, FJobSystem& jobs)
+    {
+        const int count = world.Count;
+        PseudoVelX.assign(count, 0.0f);
+        PseudoVelY.assign(count, 0.0f);
+        PseudoVelZ.assign(count, 0.0f);
+
+        for (int iteration = 0; iteration < MaxIterations; iteration++)
+        {
+            const float residual = ForEachBatch(jobs, [this, &world](FSolverContact& contact)
+            {
+                return SolvePseudoVelocity(world, contact);
+            });
+            if (residual < ResidualThreshold) break;
+        }
+
+        jobs.ParallelFor(count, SolveGrain * 8, [this, &world, dt](int, int begin, int end)
+        {
+            for (int i = begin; i < end; i++)
+            {
+                world.PosX[i] += PseudoVelX[i] * dt;
+                world.PosY[i] += PseudoVelY[i] * dt;
+                world.PosZ[i] += PseudoVelZ[i] * dt;
+            }
+        });
+    }
+
+    float SolvePseudoVelocity(const FBallWorld& world, FSolverContact& contact)
+    {
+        if (contact.PositionBias <= 0.0f && contact.PseudoImpulse <= 0.0f) return 0.0f;
+
+        const int a = contact.A;
+        const int b = contact.B;
+        float velAlongNormal = -(PseudoVelX[a] * contact.NormalX + PseudoVelY[a] * contact.NormalY + PseudoVelZ[a] * contact.NormalZ);
+        if (b >= 0)
+            velAlongNormal += PseudoVelX[b] * contact.NormalX + PseudoVelY[b] * contact.NormalY + PseudoVelZ[b] * contact.NormalZ;
+
+        const float lambda = contact.EffectiveMass * (contact.PositionBias - velAlongNormal);
+        const float oldImpulse = contact.PseudoImpulse;
+        contact.PseudoImpulse = std::max(oldImpulse + lambda, 0.0f);
+        const float delta = contact.PseudoImpulse - oldImpulse;
+        if (delta == 0.0f) return 0.0f;
+
+        // 잠든 공은 쓰지 않는다 (ApplyImpulse와 같은 이유)
+        const float invMassA = world.InvMass[a];
+        if (invMassA != 0.0f)
+        {
+            PseudoVelX[a] -= contact.NormalX * delta * invMassA;
+            PseudoVelY[a] -= contact.NormalY * delta * invMassA;
+            PseudoVelZ[a] -= contact.NormalZ * delta * invMassA;
+        }
+        if (b >= 0 && world.InvMass[b] != 0.0f)
+        {
+            const float invMassB = world.InvMass[b];
+            PseudoVelX[b] += contact.NormalX * delta * invMassB;
+            PseudoVelY[b] += contact.NormalY * delta * invMassB;
+            PseudoVelZ[b] += contact.NormalZ * delta * invMassB;
+        }
+        return fabsf(delta) / contact.EffectiveMass;
+    }
+
+    bool bApplyWarmStart = true;
+
+    std::vector<uint64_t> BallColors;        // 공마다 이미 쓴 색 비트
+    std::vector<int> ContactColor;           // 접촉마다 받은 색 (MaxColors면 직렬 배치)
+    std::vector<int> BatchStart;             // 색별 시작 위치 (MaxColors + 2개)
+    std::vector<int> BatchFill;
+    std::vector<FSolverContact> WallContacts;
+    std::vector<FSolverContact> Unsorted;    // 공끼리 접촉 + 벽 접촉 + 장애물 접촉 (색칠 전)
+    std::vector<FSolverContact> Batched;     // 색 순서로 다시 늘어놓은 접촉
+    std::vector<float> ChunkResidual;
+    std::vector<int> ChunkWarmStarted;
+    std::vector<FCachedImpulse> Cache;       // Key로 정렬된 누적 충격량
+    std::vector<float> PseudoVelX, PseudoVelY, PseudoVelZ; // 공마다 겹침을 푸는 의사 속도 (Solve마다 0에서 시작)
+};
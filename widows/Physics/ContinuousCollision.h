@@ -0,0 +1,257 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "Vector.h"
+#include "Contact.h"
+#include "BallWorld.h"
+#include "SpatialHash.h"
+#include "JobSystem.h"
+
+// 빠른 공을 위한 연속 충돌 검사 (CCD)
+// 한 스텝 동안 반지름에 비해 많이 움직인 공만 골라, 스텝 시작 위치(PrevPos)에서 끝 위치(Pos)까지
+// 지나간 구끼리 처음 닿는 시각(TOI)을 구한다. 닿은 쌍은 그 시각으로 되돌려 튕긴 뒤 남은 시간만큼만 다시 움직인다.
+// 느린 공끼리는 이산 충돌 처리(ProcessCollisions)에 그대로 맡긴다.
+// 이번 스텝에 상자 벽에 튕긴 공은 튕기기 전의 직선 경로로 펴서 검사하고, 벽에 닿기 전의 TOI만 받는다.
+class FContinuousCollision
+{
+public:
+    // 한 스텝 이동 거리가 반지름의 이 비율을 넘으면 빠른 공으로 본다
+    // (이번 스텝에 중력으로 붙은 이동량을 빼고도 넘어야 한다. 그래야 쌓여 있는 작은 공이 빠른 공으로 잡히지 않는다)
+    float MotionThreshold = 0.5f;
+
+    int NumFastBalls = 0; // 마지막 Solve의 빠른 공 수
+    int NumImpacts = 0;   // 마지막 Solve에서 TOI로 처리한 쌍 수
+
+    // Update로 dt만큼 적분한 직후에 호출한다 (PrevPos는 스텝 시작 위치여야 함, gravityY는 Update에 준 값)
+    void Solve(FBallWorld& world, float dt, float gravityY, FJobSystem& jobs)
+    {
+        NumImpacts = 0;
+        if (!FindFastBalls(world, dt, gravityY * dt * dt)) return;
+
+        // 지나간 경로 전체를 덮는 구(중점 + 반 이동 거리)로 후보 쌍을 찾는다 (격자에는 빠른 공만 넣는다)
+        BroadPhase.FindPairsAgainst(SweptX.data(), SweptY.data(), SweptZ.data(), SweptRadius.data(), world.Count,
+            FastBalls.data(), NumFastBalls, IsFast.data(), jobs, Pairs);
+
+        // 쌍마다 TOI 계산
+        Impacts.clear();
+        for (const FCollisionPair& pair : Pairs)
+        {
+            if (Handled[pair.A] || Handled[pair.B]) continue; // 경로를 펼 수 없는 공
+            float toi;
+            if (ComputeTimeOfImpact(world, pair.A, pair.B, toi))
+                Impacts.push_back({ toi, pair.A, pair.B });
+        }
+        if (Impacts.empty()) return;
+
+        // 먼저 닿는 쌍부터 처리하고, 이미 처리한 공이 낀 쌍은 이산 충돌 처리에 맡긴다
+        std::sort(Impacts.begin(), Impacts.end(), [](const FImpact& l, const FImpact& r)
+        {
+            if (l.Time != r.Time) return l.Time < r.Time;
+            if (l.A != r.A) return l.A < r.A;
+            return l.B < r.B;
+        });
+
+        const FBallArrays arrays = world.GetArrays();
+        for (const FImpact& impact : Impacts)
+        {
+            const int a = impact.A;
+            const int b = impact.B;
+            if (Handled[a] || Handled[b]) continue;
+            Handled[a] = Handled[b] = 1;
+
+            // 닿는 시각의 위치와 속도로 되돌린다 (잠든 공은 PrevPos == Pos라 그대로 있다)
+            // 벽에 닿기 전이므로 벽에서 뒤집힌 속도도 튕기기 전으로 돌린다. 벽은 남은 시간을 적분할 때 다시 만난다
+            RewindToTime(world, a, impact.Time, dt);
+            RewindToTime(world, b, impact.Time, dt);
+
+            FContact contact;
+            contact.A = a;
+            contact.B = b;
+            const FVector delta(world.PosX[b] - world.PosX[a], world.PosY[b] - world.PosY[a], world.PosZ[b] - world.PosZ[a]);
+            const float distance = sqrtf(delta.Dot(delta));
+            if (distance < 1e-6f) continue;
+            contact.NormalX = delta.x / distance;
+            contact.NormalY = delta.y / distance;
+            contact.NormalZ = delta.z / distance;
+            contact.Penetration = 0.0f;
+
+            // 잠든 공은 SleepVelocity보다 빠르게 다가올 때만 깨운다. 아니면 움직이지 않는 공으로 받아 낸다
+            const float approachSpeed =
+                (world.VelX[a] - world.VelX[b]) * contact.NormalX +
+                (world.VelY[a] - world.VelY[b]) * contact.NormalY +
+                (world.VelZ[a] - world.VelZ[b]) * contact.NormalZ;
+            if (approachSpeed > world.SleepVelocity)
+            {
+                world.WakeUp(a);
+                world.WakeUp(b);
+            }
+            world.ResolveContact(contact);
+
+            // 남은 시간만큼 새 속도로 이동 (벽 반사 포함, 중력은 이미 속도에 반영됨)
+            const float remaining = (1.0f - impact.Time) * dt;
+            if (world.Awake[a]) IntegrateBalls(arrays, a, a + 1, remaining, 0.0f, world.WallRestitution);
+            if (world.Awake[b]) IntegrateBalls(arrays, b, b + 1, remaining, 0.0f, world.WallRestitution);
+            NumImpacts++;
+        }
+    }
+
+private:
+    struct FImpact
+    {
+        float Time; // 스텝 안에서 닿는 시각 (0 ~ 1)
+        int A;
+        int B;
+    };
+
+    // 빠른 공을 고르고, 모든 공의 지나간 경로를 덮는 구를 만든다
+    // gravityDrop은 이번 스텝에 중력이 더한 y 이동량 (g * dt^2)
+    bool FindFastBalls(const FBallWorld& world, float dt, float gravityDrop)
+    {
+        const int count = world.Count;
+        IsFast.assign(count, 0);
+        Handled.assign(count, 0);
+        FastBalls.clear();
+        EndX.resize(count);
+        EndY.resize(count);
+        EndZ.resize(count);
+        WallTime.resize(count);
+
+        for (int i = 0; i < count; i++)
+        {
+            if (!UnfoldWallBounce(world, i, dt))
+            {
+                Handled[i] = 1;
+                continue;
+            }
+
+            const float dx = EndX[i] - world.PrevPosX[i];
+            const float dy = EndY[i] - world.PrevPosY[i];
+            const float dz = EndZ[i] - world.PrevPosZ[i];
+            const float threshold = MotionThreshold * world.Radius[i];
+            const float thresholdSq = threshold * threshold;
+
+            // 다른 공 위에 놓인 공은 중력만큼 내려오고, 바닥에 놓인 공은 적분에서 벽에 붙어 거의 안 움직인다.
+            // 두 경우 모두 빠른 공이 아니므로, 실제 이동량과 중력분을 뺀 이동량이 둘 다 넘어야 한다
+            const float restDy = dy - gravityDrop;
+            if (dx * dx + dy * dy + dz * dz > thresholdSq && dx * dx + restDy * restDy + dz * dz > thresholdSq)
+            {
+                IsFast[i] = 1;
+                FastBalls.push_back(i);
+            }
+        }
+
+        NumFastBalls = (int)FastBalls.size();
+        if (NumFastBalls == 0) return false;
+
+        SweptX.resize(count);
+        SweptY.resize(count);
+        SweptZ.resize(count);
+        SweptRadius.resize(count);
+        for (int i = 0; i < count; i++)
+        {
+            const float dx = EndX[i] - world.PrevPosX[i];
+            const float dy = EndY[i] - world.PrevPosY[i];
+            const float dz = EndZ[i] - world.PrevPosZ[i];
+            SweptX[i] = world.PrevPosX[i] + dx * 0.5f;
+            SweptY[i] = world.PrevPosY[i] + dy * 0.5f;
+            SweptZ[i] = world.PrevPosZ[i] + dz * 0.5f;
+            SweptRadius[i] = world.Radius[i] + 0.5f * sqrtf(dx * dx + dy * dy + dz * dz);
+        }
+        return true;
+    }
+
+    // 공 i의 경로 끝(End)과 벽에 닿은 시각(WallTime)을 채운다.
+    // 적분 커널은 벽을 넘은 공을 벽에 붙이고 그 축의 속도에 -WallRestitution을 곱하므로, 벽에 붙어 있으면서
+    // 그 벽 쪽으로 움직인 축은 속도를 되돌려 튕기기 전의 끝 위치를 구한다 (벽에 놓여 있던 공은 움직이지 않았으므로 아님).
+    // 벽 반발 계수가 0이면 속도를 되돌릴 수 없으므로 false
+    bool UnfoldWallBounce(const FBallWorld& world, int i, float dt)
+    {
+        const float lo = -1.0f + world.Radius[i];
+        const float hi = 1.0f - world.Radius[i];
+        const float* pos[3] = { world.PosX, world.PosY, world.PosZ };
+        const float* prev[3] = { world.PrevPosX, world.PrevPosY, world.PrevPosZ };
+        const float* vel[3] = { world.VelX, world.VelY, world.VelZ };
+        float* end[3] = { EndX.data(), EndY.data(), EndZ.data() };
+
+        WallTime[i] = 1.0f;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            const float p = pos[axis][i];
+            const float start = prev[axis][i];
+            end[axis][i] = p;
+            if (!((p == lo && p < start) || (p == hi && p > start))) continue;
+
+            if (world.WallRestitution <= 0.0f) return false;
+            const float move = -vel[axis][i] / world.WallRestitution * dt;
+            if (move == 0.0f) return false;
+            end[axis][i] = start + move;
+            WallTime[i] = std::min(WallTime[i], (p - start) / move);
+        }
+        return true;
+    }
+
+    // 두 구가 스텝 시작에는 떨어져 있다가 스텝 안에서 닿으면 그 시각을 구한다
+    // |p + d t| = rA + rB 의 작은 근 (p: 시작 위치 차, d: 이동량 차)
+    // 벽에 튕긴 공은 벽에 닿기 전까지만 직선 경로이므로 그 뒤의 근은 버린다
+    bool ComputeTimeOfImpact(const FBallWorld& world, int a, int b, float& outTime) const
+    {
+        const float px = world.PrevPosX[b] - world.PrevPosX[a];
+        const float py = world.PrevPosY[b] - world.PrevPosY[a];
+        const float pz = world.PrevPosZ[b] - world.PrevPosZ[a];
+        const float dx = (EndX[b] - world.PrevPosX[b]) - (EndX[a] - world.PrevPosX[a]);
+        const float dy = (EndY[b] - world.PrevPosY[b]) - (EndY[a] - world.PrevPosY[a]);
+        const float dz = (EndZ[b] - world.PrevPosZ[b]) - (EndZ[a] - world.PrevPosZ[a]);
+        const float sumRadius = world.Radius[a] + world.Radius[b];
+
+        const float c = px * px + py * py + pz * pz - sumRadius * sumRadius;
+        if (c <= 0.0f) return false; // 이미 겹쳐 있으면 이산 처리에 맡긴다
+
+        const float qa = dx * dx + dy * dy + dz * dz;
+        const float qb = px * dx + py * dy + pz * dz;
+        if (qb >= 0.0f || qa < 1e-12f) return false; // 멀어지는 중
+
+        const float discriminant = qb * qb - qa * c;
+        if (discriminant < 0.0f) return false;
+
+        const float t = (-qb - sqrtf(discriminant)) / qa;
+        if (t < 0.0f || t > std::min(WallTime[a], WallTime[b])) return false;
+
+        outTime = t;
+        return true;
+    }
+
+    void RewindToTime(FBallWorld& world, int i, float t, float dt) const
+    {
+        const float dx = EndX[i] - world.PrevPosX[i];
+        const float dy = EndY[i] - world.PrevPosY[i];
+        const float dz = EndZ[i] - world.PrevPosZ[i];
+        world.PosX[i] = world.PrevPosX[i] + dx * t;
+        world.PosY[i] = world.PrevPosY[i] + dy * t;
+        world.PosZ[i] = world.PrevPosZ[i] + dz * t;
+        if (WallTime[i] < 1.0f)
+        {
+            world.VelX[i] = dx / dt;
+            world.VelY[i] = dy / dt;
+            world.VelZ[i] = dz / dt;
+        }
+    }
+
+    FSpatialHash BroadPhase;
+    std::vector<FCollisionPair> Pairs;
+    std::vector<FImpact> Impacts;
+    std::vector<int> FastBalls;
+    std::vector<uint8_t> IsFast;
+    std::vector<uint8_t> Handled;
+    std::vector<float> SweptX;
+    std::vector<float> SweptY;
+    std::vector<float> SweptZ;
+    std::vector<float> SweptRadius;
+    std::vector<float> EndX;     // 벽에 튕기기 전의 직선 경로로 편 끝 위치 (튕기지 않았으면 Pos)
+    std::vector<float> EndY;
+    std::vector<float> EndZ;
+    std::vector<float> WallTime; // 스텝 안에서 벽에 닿은 시각 (0 ~ 1, 닿지 않았으면 1)
+};
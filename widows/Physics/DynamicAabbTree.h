@@ -0,0 +1,521 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+
+#include "Vector.h"
+
+// 공 집합에 대한 동적 AABB 트리 (공간 질의용)
+// 잎마다 공 하나의 AABB를 FatMargin만큼 넓혀 두고, 공이 넓힌 상자를 벗어날 때만 그 잎을 빼서 다시 넣는다.
+// 넣을 때는 표면적이 가장 덜 늘어나는 자리를 고르고, 올라오면서 회전으로 높이 균형을 맞춘다.
+// 질의는 모두 호출한 쪽이 준 버퍼에 결과를 채우며, 고정 크기 스택으로 순회해서 메모리를 할당하지 않는다.
+class FDynamicAabbTree
+{
+public:
+    static const int NullNode = -1;
+
+    // 잎 상자를 공 AABB보다 이만큼 넓게 잡는다 (클수록 다시 넣는 일이 줄고 질의 후보는 늘어난다)
+    float FatMargin = 0.02f;
+
+    int NumReinserted = 0; // 마지막 Update에서 다시 넣은 잎 수
+
+    struct FRayHit
+    {
+        int Ball;
+        float Distance; // 시작점에서 맞은 점까지 거리
+        FVector Point;
+        FVector Normal;
+    };
+
+    // 공 인덱스가 바뀌었을 때(추가/제거/재배치) 호출하면 다음 Update에서 처음부터 다시 만든다
+    void Invalidate()
+    {
+        bValid = false;
+    }
+
+    // 현재 위치로 트리를 갱신한다. 질의하기 전에 불러야 한다
+    void Update(const float* x, const float* y, const float* z, const float* radius, int count)
+    {
+        X = x; Y = y; Z = z; Radius = radius;
+        NumReinserted = 0;
+
+        if (!bValid || count != Count)
+        {
+            Count = count;
+            Rebuild();
+            return;
+        }
+
+        for (int i = 0; i < Count; i++)
+        {
+            const int leaf = LeafOfBall[i];
+            if (Contains(Nodes[leaf], i)) continue;
+
+            RemoveLeaf(leaf);
+            SetFatBox(Nodes[leaf], i);
+            InsertLeaf(leaf);
+            NumReinserted++;
+        }
+    }
+
+    // 상자와 AABB가 겹치는 공을 outBalls에 채우고 개수를 반환한다 (capacity를 넘으면 거기서 멈춤)
+    int QueryAABB(const FVector& boxMin, const FVector& boxMax, int* outBalls, int capacity) const
+    {
+        int numFound = 0;
+        if (capacity <= 0) return 0;
+        const float lo[3] = { boxMin.x, boxMin.y, boxMin.z };
+        const float hi[3] = { boxMax.x, boxMax.y, boxMax.z };
+        Traverse(
+            [&lo, &hi](const FNode& node) { return OverlapsBox(node, lo, hi); },
+            [this, &lo, &hi, outBalls, capacity, &numFound](int ball)
+            {
+                const float r = Radius[ball];
+                if (X[ball] - r > hi[0] || X[ball] + r < lo[0] ||
+                    Y[ball] - r > hi[1] || Y[ball] + r < lo[1] ||
+                    Z[ball] - r > hi[2] || Z[ball] + r < lo[2]) return true;
+                outBalls[numFound++] = ball;
+                return numFound < capacity;
+            });
+        return numFound;
+    }
+
+    // center에서 radius 안에 걸치는 공을 outBalls에 채우고 개수를 반환한다
+    int QueryRadius(const FVector& center, float radius, int* outBalls, int capacity) const
+    {
+        int numFound = 0;
+        if (capacity <= 0) return 0;
+        const float lo[3] = { center.x - radius, center.y - radius, center.z - radius };
+        const float hi[3] = { center.x + radius, center.y + radius, center.z + radius };
+        Traverse(
+            [&lo, &hi](const FNode& node) { return OverlapsBox(node, lo, hi); },
+            [this, &center, radius, outBalls, capacity, &numFound](int ball)
+            {
+                const float dx = X[ball] - center.x;
+                const float dy = Y[ball] - center.y;
+                const float dz = Z[ball] - center.z;
+                const float reach = radius + Radius[ball];
+                if (dx * dx + dy * dy + dz * dz > reach * reach) return true;
+                outBalls[numFound++] = ball;
+                return numFound < capacity;
+            });
+        return numFound;
+    }
+
+    // origin에서 direction 방향으로 maxDistance까지 가장 먼저 맞는 공을 찾는다
+    bool RayCast(const FVector& origin, const FVector& direction, float maxDistance, FRayHit& outHit) const
+    {
+        const float length = sqrtf(direction.Dot(direction));
+        if (length < 1e-12f) return false;
+        const float dir[3] = { direction.x / length, direction.y / length, direction.z / length };
+        const float org[3] = { origin.x, origin.y, origin.z };
+        float invDir[3];
+        for (int axis = 0; axis < 3; axis++)
+            invDir[axis] = fabsf(dir[axis]) > 1e-12f ? 1.0f / dir[axis] : (dir[axis] < 0.0f ? -FLT_MAX : FLT_MAX);
+
+        // 지금까지 가장 가까운 거리보다 먼 노드는 건너뛴다
+        float closest = maxDistance;
+        int hitBall = NullNode;
+        Traverse(
+            [&org, &invDir, &closest](const FNode& node) { return RayHitsBox(node, org, invDir, closest); },
+            [this, &org, &dir, &closest, &hitBall](int ball)
+            {
+                // |org + dir t - c| = r 의 작은 근
+                const float px = org[0] - X[ball];
+                const float py = org[1] - Y[ball];
+                const float pz = org[2] - Z[ball];
+                const float b = px * dir[0] + py * dir[1] + pz * dir[2];
+                const float c = px * px + py * py + pz * pz - Radius[ball] * Radius[ball];
+                if (c > 0.0f && b > 0.0f) return true; // 공 밖에서 멀어지는 방향
+                const float discriminant = b * b - c;
+                if (discriminant < 0.0f) return true;
+
+                const float t = std::max(-b - sqrtf(discriminant), 0.0f); // 시작점이 공 안이면 0
+                if (t < closest)
+                {
+                    closest = t;
+                    hitBall = ball;
+                }
+                return true;
+            });
+
+        if (hitBall == NullNode) return false;
+
+        outHit.Ball = hitBall;
+        outHit.Distance = closest;
+        outHit.Point = FVector(org[0] + dir[0] * closest, org[1] + dir[1] * closest, org[2] + dir[2] * closest);
+        const FVector toPoint(outHit.Point.x - X[hitBall], outHit.Point.y - Y[hitBall], outHit.Point.z - Z[hitBall]);
+        const float toPointLength = sqrtf(toPoint.Dot(toPoint));
+        outHit.Normal = toPointLength > 1e-12f ? toPoint * (1.0f / toPointLength) : FVector(-dir[0], -dir[1], -dir[2]);
+        return true;
+    }
+
+    // point를 품은 공 중 중심이 가장 가까운 공 (없으면 -1)
+    int PickPoint(const FVector& point) const
+    {
+        const float p[3] = { point.x, point.y, point.z };
+        float closestSq = FLT_MAX;
+        int picked = NullNode;
+        Traverse(
+            [&p](const FNode& node) { return OverlapsBox(node, p, p); },
+            [this, &point, &closestSq, &picked](int ball)
+            {
+                const float dx = X[ball] - point.x;
+                const float dy = Y[ball] - point.y;
+                const float dz = Z[ball] - point.z;
+                const float distanceSq = dx * dx + dy * dy + dz * dz;
+                if (distanceSq <= Radius[ball] * Radius[ball] && distanceSq < closestSq)
+                {
+                    closestSq = distanceSq;
+                    picked = ball;
+                }
+                return true;
+            });
+        return picked;
+    }
+
+    int GetHeight() const { return Root == NullNode ? 0 : Nodes[Root].Height; }
+
+private:
+    struct FNode
+    {
+        float Min[3];
+        float Max[3];
+        int Parent;     // 빈 노드면 다음 빈 노드
+        int Child1;
+        int Child2;
+        int Height;     // 잎은 0, 빈 노드는 -1
+        int Ball;       // 잎이 가리키는 공
+
+        bool IsLeaf() const { return Child1 == NullNode; }
+    };
+
+    // 순회 스택 크기 (균형 잡힌 트리라 100만 개여도 깊이는 수십 단계)
+    static const int StackSize = 256;
+
+    // overlaps(node)가 참인 노드만 내려가며 잎마다 visit(ball)을 부른다. visit가 거짓을 반환하면 멈춘다
+    template <typename OverlapFunc, typename VisitFunc>
+    void Traverse(const OverlapFunc& overlaps, const VisitFunc& visit) const
+    {
+        if (Root == NullNode) return;
+
+        int stack[StackSize];
+        int top = 0;
+        stack[top++] = Root;
+        while (top > 0)
+        {
+            const FNode& node = Nodes[stack[--top]];
+            if (!overlaps(node)) continue;
+
+            if (node.IsLeaf())
+            {
+                if (!visit(node.Ball)) return;
+                continue;
+            }
+            if (top + 2 > StackSize) continue; // 여기까지 깊어질 일은 없지만 넘치지 않게 막는다
+            stack[top++] = node.Child1;
+            stack[top++] = node.Child2;
+        }
+    }
+
+    static bool OverlapsBox(const FNode& node, const float* lo, const float* hi)
+    {
+        return node.Min[0] <= hi[0] && node.Max[0] >= lo[0] &&
+               node.Min[1] <= hi[1] && node.Max[1] >= lo[1] &&
+               node.Min[2] <= hi[2] && node.Max[2] >= lo[2];
+    }
+
+    // 슬랩 검사: 광선이 [0, maxDistance] 안에서 상자를 지나는지
+    static bool RayHitsBox(const FNode& node, const float* org, const float* invDir, float maxDistance)
+    {
+        float tMin = 0.0f;
+        float tMax = maxDistance;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            float t1 = (node.Min[axis] - org[axis]) * invDir[axis];
+            float t2 = (node.Max[axis] - org[axis]) * invDir[axis];
+            if (t1 > t2) std::swap(t1, t2);
+            tMin = std::max(tMin, t1);
+            tMax = std::min(tMax, t2);
+            if (tMin > tMax) return false;
+        }
+        return true;
+    }
+
+    static float SurfaceArea(const float* lo, const float* hi)
+    {
+        const float dx = hi[0] - lo[0];
+        const float dy = hi[1] - lo[1];
+        const float dz = hi[2] - lo[2];
+        return 2.0f * (dx * dy + dy * dz + dz * dx);
+    }
+
+    // 두 노드 상자를 합친 상자의 표면적
+    static float UnionArea(const FNode& a, const FNode& b)
+    {
+        float lo[3], hi[3];
+        for (int axis = 0; axis < 3; axis++)
+        {
+            lo[axis] = std::min(a.Min[axis], b.Min[axis]);
+            hi[axis] = std::max(a.Max[axis], b.Max[axis]);
+        }
+        return SurfaceArea(lo, hi);
+    }
+
+    static float Area(const FNode& node)
+    {
+        return SurfaceArea(node.Min, node.Max);
+    }
+
+    // 넓힌 잎 상자가 공의 AABB를 아직 품고 있는지
+    bool Contains(const FNode& leaf, int i) const
+    {
+        const float r = Radius[i];
+        return leaf.Min[0] <= X[i] - r && leaf.Max[0] >= X[i] + r &&
+               leaf.Min[1] <= Y[i] - r && leaf.Max[1] >= Y[i] + r &&
+               leaf.Min[2] <= Z[i] - r && leaf.Max[2] >= Z[i] + r;
+    }
+
+    void SetFatBox(FNode& leaf, int i) const
+    {
+        const float extent = Radius[i] + FatMargin;
+        leaf.Min[0] = X[i] - extent; leaf.Max[0] = X[i] + extent;
+        leaf.Min[1] = Y[i] - extent; leaf.Max[1] = Y[i] + extent;
+        leaf.Min[2] = Z[i] - extent; leaf.Max[2] = Z[i] + extent;
+    }
+
+    // 자식 둘의 상자와 높이로 부모를 다시 계산
+    void Refit(int index)
+    {
+        FNode& node = Nodes[index];
+        const FNode& child1 = Nodes[node.Child1];
+        const FNode& child2 = Nodes[node.Child2];
+        for (int axis = 0; axis < 3; axis++)
+        {
+            node.Min[axis] = std::min(child1.Min[axis], child2.Min[axis]);
+            node.Max[axis] = std::max(child1.Max[axis], child2.Max[axis]);
+        }
+        node.Height = 1 + std::max(child1.Height, child2.Height);
+    }
+
+    int AllocateNode()
+    {
+        if (FreeList == NullNode)
+        {
+            Nodes.push_back(FNode());
+            FreeList = (int)Nodes.size() - 1;
+            Nodes[FreeList].Parent = NullNode;
+        }
+
+        const int index = FreeList;
+        FNode& node = Nodes[index];
+        FreeList = node.Parent;
+        node.Parent = NullNode;
+        node.Child1 = NullNode;
+        node.Child2 = NullNode;
+        node.Height = 0;
+        node.Ball = NullNode;
+        return index;
+    }
+
+    void FreeNode(int index)
+    {
+        Nodes[index].Parent = FreeList;
+        Nodes[index].Height = -1;
+        FreeList = index;
+    }
+
+    void Rebuild()
+    {
+        Nodes.clear();
+        Nodes.reserve(Count * 2);
+        FreeList = NullNode;
+        Root = NullNode;
+        LeafOfBall.resize(Count);
+        for (int i = 0; i < Count; i++)
+        {
+            const int leaf = AllocateNode();
+            Nodes[leaf].Ball = i;
+            SetFatBox(Nodes[leaf], i);
+            InsertLeaf(leaf);
+            LeafOfBall[i] = leaf;
+        }
+        bValid = true;
+    }
+
+    void InsertLeaf(int leaf)
+    {
+        if (Root == NullNode)
+        {
+            Root = leaf;
+            Nodes[Root].Parent = NullNode;
+            return;
+        }
+
+        // 1. 표면적 증가가 가장 적은 형제 찾기
+        int index = Root;
+        while (!Nodes[index].IsLeaf())
+        {
+            const FNode& node = Nodes[index];
+            const FNode& leafNode = Nodes[leaf];
+            const float area = Area(node);
+            const float combinedArea = UnionArea(node, leafNode);
+
+            // 여기서 새 부모를 만드는 비용과, 아래로 내려갈 때 조상들이 커지는 비용
+            const float cost = 2.0f * combinedArea;
+            const float inheritanceCost = 2.0f * (combinedArea - area);
+
+            const FNode& child1 = Nodes[node.Child1];
+            const FNode& child2 = Nodes[node.Child2];
+            const float cost1 = (child1.IsLeaf() ? UnionArea(child1, leafNode) : UnionArea(child1, leafNode) - Area(child1)) + inheritanceCost;
+            const float cost2 = (child2.IsLeaf() ? UnionArea(child2, leafNode) : UnionArea(child2, leafNode) - Area(child2)) + inheritanceCost;
+
+            if (cost < cost1 && cost < cost2) break;
+            index = cost1 < cost2 ? node.Child1 : node.Child2;
+        }
+
+        // 2. 형제와 새 잎을 묶는 부모를 만든다
+        const int sibling = index;
+        const int oldParent = Nodes[sibling].Parent;
+        const int newParent = AllocateNode();
+        Nodes[newParent].Parent = oldParent;
+        Nodes[newParent].Child1 = sibling;
+        Nodes[newParent].Child2 = leaf;
+        Nodes[sibling].Parent = newParent;
+        Nodes[leaf].Parent = newParent;
+        Refit(newParent);
+
+        if (oldParent != NullNode)
+        {
+            if (Nodes[oldParent].Child1 == sibling)
+                Nodes[oldParent].Child1 = newParent;
+            else
+                Nodes[oldParent].Child2 = newParent;
+        }
+        else
+        {
+            Root = newParent;
+        }
+
+        // 3. 올라가면서 균형을 맞추고 상자를 다시 계산
+        FixUpwards(Nodes[leaf].Parent);
+    }
+
+    void RemoveLeaf(int leaf)
+    {
+        if (leaf == Root)
+        {
+            Root = NullNode;
+            return;
+        }
+
+        const int parent = Nodes[leaf].Parent;
+        const int grandParent = Nodes[parent].Parent;
+        const int sibling = Nodes[parent].Child1 == leaf ? Nodes[parent].Child2 : Nodes[parent].Child1;
+
+        // 부모를 없애고 형제를 그 자리에 올린다
+        if (grandParent != NullNode)
+        {
+            if (Nodes[grandParent].Child1 == parent)
+                Nodes[grandParent].Child1 = sibling;
+            else
+                Nodes[grandParent].Child2 = sibling;
+            Nodes[sibling].Parent = grandParent;
+            FreeNode(parent);
+            FixUpwards(grandParent);
+        }
+        else
+        {
+            Root = sibling;
+            Nodes[sibling].Parent = NullNode;
+            FreeNode(parent);
+        }
+    }
+
+    void FixUpwards(int index)
+    {
+        while (index != NullNode)
+        {
+            index = Balance(index);
+            Refit(index);
+            index = Nodes[index].Parent;
+        }
+    }
+
+    // iA의 두 자식 높이가 2 이상 차이 나면 높은 쪽 자식을 위로 올리는 회전을 하고, 그 자리의 새 노드를 반환
+    /*
+           A            C
+          / \          / \
+         B   C   ->   A   F (또는 G)
+            / \      / \
+           F   G    B   G (또는 F)
+    */
+    int Balance(int iA)
+    {
+        FNode& A = Nodes[iA];
+        if (A.IsLeaf() || A.Height < 2) return iA;
+
+        const int iB = A.Child1;
+        const int iC = A.Child2;
+        const int balance = Nodes[iC].Height - Nodes[iB].Height;
+
+        if (balance > 1) return Rotate(iA, iC, true);
+        if (balance < -1) return Rotate(iA, iB, false);
+        return iA;
+    }
+
+    // iHigh(A의 높은 자식)를 A 자리로 올린다. bHighIsChild2는 iHigh가 A의 Child2였는지
+    int Rotate(int iA, int iHigh, bool bHighIsChild2)
+    {
+        FNode& A = Nodes[iA];
+        FNode& C = Nodes[iHigh];
+        const int iF = C.Child1;
+        const int iG = C.Child2;
+
+        // C를 A의 부모 자리로
+        C.Child1 = iA;
+        C.Parent = A.Parent;
+        A.Parent = iHigh;
+        if (C.Parent != NullNode)
+        {
+            if (Nodes[C.Parent].Child1 == iA)
+                Nodes[C.Parent].Child1 = iHigh;
+            else
+                Nodes[C.Parent].Child2 = iHigh;
+        }
+        else
+        {
+            Root = iHigh;
+        }
+
+        // F와 G 중 높은 쪽은 C에 남기고, 낮은 쪽은 A의 자식으로 내린다
+        int iKeep = iF;
+        int iMove = iG;
+        if (Nodes[iF].Height < Nodes[iG].Height)
+            std::swap(iKeep, iMove);
+
+        C.Child2 = iKeep;
+        if (bHighIsChild2)
+            A.Child2 = iMove;
+        else
+            A.Child1 = iMove;
+        Nodes[iMove].Parent = iA;
+
+        Refit(iA);
+        Refit(iHigh);
+        return iHigh;
+    }
+
+    const float* X = nullptr;
+    const float* Y = nullptr;
+    const float* Z = nullptr;
+    const float* Radius = nullptr;
+    int Count = 0;
+    bool bValid = false;
+
+    std::vector<FNode> Nodes;
+    std::vector<int> LeafOfBall; // 공마다 자기 잎 노드
+    int Root = NullNode;
+    int FreeList = NullNode;
+};
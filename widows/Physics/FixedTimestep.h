@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cmath>
+
+// 고정 간격 시뮬레이션 시계
+// 실제로 흐른 시간을 누적해 두고 StepTime 단위로만 물리를 진행한다.
+// 남은 시간(Alpha)은 렌더링할 때 이전 상태와 현재 상태 사이를 보간하는 데 쓴다.
+struct FFixedTimestep
+{
+    float StepTime = 1.0f / 60.0f; // 물리 한 스텝의 길이 (초)
+    int MaxSubsteps = 4;           // 한 프레임에 진행할 최대 스텝 수 (프레임이 멈췄을 때 따라잡기 제한)
+
+    double Accumulator = 0.0;      // 아직 시뮬레이션하지 않은 시간
+    int LastSteps = 0;             // 마지막 Advance에서 진행한 스텝 수
+
+    // frameTime만큼 시간을 흘리고 이번 프레임에 진행할 스텝 수를 반환한다
+    int Advance(double frameTime)
+    {
+        Accumulator += frameTime;
+
+        int steps = (int)(Accumulator / StepTime);
+        if (steps > MaxSubsteps)
+        {
+            // 따라잡지 못한 시간은 버린다 (느려질 뿐 한 스텝이 커지지는 않음)
+            steps = MaxSubsteps;
+            Accumulator = fmod(Accumulator, (double)StepTime);
+        }
+        else
+        {
+            Accumulator -= steps * (double)StepTime;
+        }
+
+        LastSteps = steps;
+        return steps;
+    }
+
+    // 이전 스텝과 현재 스텝 사이 어디를 그릴지 (0 ~ 1)
+    float GetAlpha() const
+    {
+        return (float)(Accumulator / StepTime);
+    }
+};
@@ -0,0 +1,286 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <algorithm>
+
+class FJobCounter;
+
+// 작업 하나: 실행할 함수와, 끝났을 때 줄여 줄 카운터
+struct FJob
+{
+    std::function<void()> Func;
+    FJobCounter* Counter = nullptr;
+};
+
+// 잡 묶음이 모두 끝났는지 추적하는 카운터
+// Run 할 때 1 늘고, 잡이 끝날 때 1 준다. 0이 되면 이 카운터를 기다리던(의존하던) 잡들이 풀려난다.
+class FJobCounter
+{
+public:
+    FJobCounter() = default;
+    FJobCounter(const FJobCounter&) = delete;
+    FJobCounter& operator=(const FJobCounter&) = delete;
+
+    bool IsDone() const { return Value.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class FJobSystem;
+
+    std::atomic<int> Value{ 0 };
+    std::mutex Lock;
+    std::vector<FJob> Continuations; // 이 카운터가 0이 되길 기다리는 잡
+};
+
+// 작업 훔치기(work stealing) 스레드 풀
+// 스레드마다 자기 큐를 갖고, 자기 큐는 뒤에서(LIFO) 꺼내고 남의 큐는 앞에서(FIFO) 훔친다.
+// 메인 스레드도 0번 일꾼으로 참여해서, Wait 중에는 직접 잡을 실행한다.
+class FJobSystem
+{
+public:
+    static const int MaxThreads = 64;
+
+    // 결정적 모드: ParallelFor가 범위를 나누는 방식이 스레드 수와 관계없이 grain만으로 정해진다.
+    // 덩어리별 결과를 덩어리 순서대로 합치면 스레드 수가 달라도 같은 결과가 나온다.
+    bool Deterministic = false;
+
+    FJobSystem()
+    {
+        Queues.emplace_back(new FWorkerQueue());
+    }
+
+    FJobSystem(const FJobSystem&) = delete;
+    FJobSystem& operator=(const FJobSystem&) = delete;
+
+    ~FJobSystem()
+    {
+        Shutdown();
+    }
+
+    // 메인 스레드를 포함해 threadCap개 스레드로 시작한다 (0이면 하드웨어 스레드 수)
+    void Start(int threadCap = 0)
+    {
+        Shutdown();
+
+        int numThreads = threadCap > 0 ? threadCap : (int)std::thread::hardware_concurrency();
+        numThreads = std::min(std::max(numThreads, 1), (int)MaxThreads);
+
+        NumThreads = numThreads;
+        Queues.clear();
+        for (int i = 0; i < NumThreads; i++)
+            Queues.emplace_back(new FWorkerQueue());
+
+        Running = true;
+        for (int i = 1; i < NumThreads; i++)
+            Workers.emplace_back([this, i]() { WorkerMain(i); });
+    }
+
+    void Shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> lock(SleepLock);
+            Running = false;
+        }
+        WakeUp.notify_all();
+        for (std::thread& worker : Workers)
+            worker.join();
+        Workers.clear();
+        NumThreads = 1;
+    }
+
+    // 메인 스레드를 포함한 스레드 수
+    int GetNumThreads() const { return NumThreads; }
+
+    // 잡을 큐에 넣는다. dependency가 있으면 그 카운터가 0이 된 뒤에 실행된다.
+    void Run(std::function<void()> func, FJobCounter* counter = nullptr, FJobCounter* dependency = nullptr)
+    {
+        FJob job;
+        job.Func = std::move(func);
+        job.Counter = counter;
+        if (counter) counter->Value.fetch_add(1, std::memory_order_relaxed);
+
+        if (dependency)
+        {
+            std::lock_guard<std::mutex> lock(dependency->Lock);
+            if (!dependency->IsDone())
+            {
+                dependency->Continuations.push_back(std::move(job));
+                return;
+            }
+        }
+        Push(std::move(job));
+    }
+
+    // 카운터가 0이 될 때까지 남은 잡을 대신 실행하며 기다린다
+    void Wait(FJobCounter& counter)
+    {
+        const int self = CurrentQueue();
+        while (!counter.IsDone())
+        {
+            FJob job;
+            if (TryGetJob(self, job))
+                Execute(job);
+            else
+                std::this_thread::yield();
+        }
+
+        // 마지막 잡이 카운터의 잠금을 놓을 때까지 기다린다 (이후 카운터를 지워도 안전)
+        std::lock_guard<std::mutex> lock(counter.Lock);
+    }
+
+    // ParallelFor 한 덩어리의 크기 (SIMD 폭에 맞춰 8의 배수)
+    int GetChunkSize(int count, int grain) const
+    {
+        int size = std::max(grain, 1);
+        if (!Deterministic)
+        {
+            // 스레드 수에 맞춰 덩어리를 키워 잡 개수를 줄인다
+            const int maxChunks = NumThreads * ChunksPerThread;
+            size = std::max(size, (count + maxChunks - 1) / maxChunks);
+        }
+        return (size + 7) & ~7;
+    }
+
+    int GetNumChunks(int count, int grain) const
+    {
+        const int size = GetChunkSize(count, grain);
+        return (count + size - 1) / size;
+    }
+
+    // [0, count)를 덩어리로 나눠 func(chunk, begin, end)를 병렬로 호출하고, 모두 끝나면 돌아온다
+    template <typename Func>
+    void ParallelFor(int count, int grain, const Func& func)
+    {
+        const int size = GetChunkSize(count, grain);
+        const int numChunks = (count + size - 1) / size;
+        if (numChunks <= 1 || NumThreads == 1)
+        {
+            for (int chunk = 0; chunk < numChunks; chunk++)
+                func(chunk, chunk * size, std::min(count, (chunk + 1) * size));
+            return;
+        }
+
+        FJobCounter counter;
+        for (int chunk = 1; chunk < numChunks; chunk++)
+        {
+            const int begin = chunk * size;
+            const int end = std::min(count, begin + size);
+            Run([&func, chunk, begin, end]() { func(chunk, begin, end); }, &counter);
+        }
+        func(0, 0, std::min(count, size));
+        Wait(counter);
+    }
+
+private:
+    static const int ChunksPerThread = 4;
+
+    struct FWorkerQueue
+    {
+        std::mutex Lock;
+        std::deque<FJob> Jobs;
+    };
+
+    // 현재 스레드의 일꾼 번호 (일꾼 스레드가 아니면 0번 큐를 같이 쓴다)
+    static int& ThreadIndex()
+    {
+        static thread_local int index = 0;
+        return index;
+    }
+
+    int CurrentQueue() const
+    {
+        const int index = ThreadIndex();
+        return index < NumThreads ? index : 0;
+    }
+
+    void Push(FJob job)
+    {
+        FWorkerQueue& queue = *Queues[CurrentQueue()];
+        {
+            std::lock_guard<std::mutex> lock(queue.Lock);
+            queue.Jobs.push_back(std::move(job));
+        }
+        PendingJobs.fetch_add(1, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(SleepLock);
+        }
+        WakeUp.notify_one();
+    }
+
+    // 자기 큐의 뒤에서 꺼내고, 비어 있으면 다른 큐의 앞에서 훔친다
+    bool TryGetJob(int self, FJob& outJob)
+    {
+        if (PendingJobs.load(std::memory_order_acquire) == 0) return false;
+
+        for (int k = 0; k < NumThreads; k++)
+        {
+            FWorkerQueue& queue = *Queues[(self + k) % NumThreads];
+            std::lock_guard<std::mutex> lock(queue.Lock);
+            if (queue.Jobs.empty()) continue;
+
+            if (k == 0)
+            {
+                outJob = std::move(queue.Jobs.back());
+                queue.Jobs.pop_back();
+            }
+            else
+            {
+                outJob = std::move(queue.Jobs.front());
+                queue.Jobs.pop_front();
+            }
+            PendingJobs.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    void Execute(FJob& job)
+    {
+        job.Func();
+
+        FJobCounter* counter = job.Counter;
+        if (!counter) return;
+
+        // 카운터가 0이 되면 의존하던 잡을 큐에 넣는다
+        std::vector<FJob> ready;
+        {
+            std::lock_guard<std::mutex> lock(counter->Lock);
+            if (counter->Value.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                ready.swap(counter->Continuations);
+        }
+        for (FJob& next : ready)
+            Push(std::move(next));
+    }
+
+    void WorkerMain(int index)
+    {
+        ThreadIndex() = index;
+        for (;;)
+        {
+            FJob job;
+            if (TryGetJob(index, job))
+            {
+                Execute(job);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(SleepLock);
+            WakeUp.wait(lock, [this]() { return !Running || PendingJobs.load(std::memory_order_acquire) > 0; });
+            if (!Running) return;
+        }
+    }
+
+    int NumThreads = 1;
+    bool Running = false;
+    std::atomic<int> PendingJobs{ 0 };
+    std::vector<std::unique_ptr<FWorkerQueue>> Queues;
+    std::vector<std::thread> Workers;
+    std::mutex SleepLock;
+    std::condition_variable WakeUp;
+};
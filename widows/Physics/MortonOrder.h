@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+// 공을 위치의 Morton 코드(Z 곡선) 순서로 늘어세우는 순서 계산기
+// 공간에서 가까운 공이 메모리에서도 가까워지도록, 위치를 축마다 10비트로 양자화해 비트를 엇갈려 놓은
+// 30비트 코드를 만들고 기수 정렬(LSD, 8비트씩 4번)로 정렬한다. 비교 정렬이 아니므로 O(n)이다.
+class FMortonOrder
+{
+public:
+    int NumRadixPasses = 0; // 마지막 Compute에서 실제로 돈 기수 정렬 패스 수 (모든 키가 같은 자릿값이면 건너뜀)
+
+    // order[새 인덱스] = 옛 인덱스인 순서를 만든다
+    const std::vector<int>& Compute(const float* x, const float* y, const float* z, int count)
+    {
+        Keys.resize(count);
+        Order.resize(count);
+        TempKeys.resize(count);
+        TempOrder.resize(count);
+        NumRadixPasses = 0;
+        if (count == 0) return Order;
+
+        // 공들을 감싸는 상자를 축마다 1024칸으로 나눈다 (한 축의 폭이 0이면 그 축 비트는 모두 0)
+        float minX = x[0], maxX = x[0], minY = y[0], maxY = y[0], minZ = z[0], maxZ = z[0];
+        for (int i = 1; i < count; i++)
+        {
+            minX = std::min(minX, x[i]); maxX = std::max(maxX, x[i]);
+            minY = std::min(minY, y[i]); maxY = std::max(maxY, y[i]);
+            minZ = std::min(minZ, z[i]); maxZ = std::max(maxZ, z[i]);
+        }
+        const float scaleX = GetQuantizeScale(minX, maxX);
+        const float scaleY = GetQuantizeScale(minY, maxY);
+        const float scaleZ = GetQuantizeScale(minZ, maxZ);
+
+        for (int i = 0; i < count; i++)
+        {
+            const uint32_t qx = (uint32_t)((x[i] - minX) * scaleX);
+            const uint32_t qy = (uint32_t)((y[i] - minY) * scaleY);
+            const uint32_t qz = (uint32_t)((z[i] - minZ) * scaleZ);
+            Keys[i] = (ExpandBits(qz) << 2) | (ExpandBits(qy) << 1) | ExpandBits(qx);
+            Order[i] = i;
+        }
+
+        RadixSort(count);
+        return Order;
+    }
+
+    // 10비트 값의 비트 사이에 0을 두 개씩 끼워 넣는다 (b9..b0 -> b9 0 0 b8 0 0 ... b0)
+    static uint32_t ExpandBits(uint32_t v)
+    {
+        v &= 0x3ff;
+        v = (v | (v << 16)) & 0x030000ff;
+        v = (v | (v << 8)) & 0x0300f00f;
+        v = (v | (v << 4)) & 0x030c30c3;
+        v = (v | (v << 2)) & 0x09249249;
+        return v;
+    }
+
+private:
+    std::vector<uint32_t> Keys;
+    std::vector<uint32_t> TempKeys;
+    std::vector<int> Order;
+    std::vector<int> TempOrder;
+
+    static float GetQuantizeScale(float min, float max)
+    {
+        const float extent = max - min;
+        return extent > 1e-12f ? 1023.0f / extent : 0.0f;
+    }
+
+    // 안정 정렬이므로 코드가 같은 공끼리는 원래 순서를 유지한다
+    void RadixSort(int count)
+    {
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            int histogram[256];
+            memset(histogram, 0, sizeof(histogram));
+            for (int i = 0; i < count; i++)
+                histogram[(Keys[i] >> shift) & 0xff]++;
+
+            // 모든 키가 같은 자릿값이면 이 패스는 순서를 바꾸지 않는다
+            if (histogram[(Keys[0] >> shift) & 0xff] == count) continue;
+
+            int offset = 0;
+            for (int digit = 0; digit < 256; digit++)
+            {
+                const int numDigit = histogram[digit];
+                histogram[digit] = offset;
+                offset += numDigit;
+            }
+
+            for (int i = 0; i < count; i++)
+            {
+                const int dst = histogram[(Keys[i] >> shift) & 0xff]++;
+                TempKeys[dst] = Keys[i];
+                TempOrder[dst] = Order[i];
+            }
+            Keys.swap(TempKeys);
+            Order.swap(TempOrder);
+            NumRadixPasses++;
+        }
+    }
+};
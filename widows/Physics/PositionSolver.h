@@ -0,0 +1,366 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "Contact.h"
+#include "BallWorld.h"
+#include "JobSystem.h"
+
+// 위치 기반(XPBD) 접촉 솔버
+// 속도를 먼저 적분해 위치를 예측하고, 겹침을 위치 제약으로 직접 풀어 낸 뒤
+// 스텝 동안 움직인 거리로 속도를 다시 구한다 (Verlet 방식). 반복 횟수가 고정이라 비용이 일정하고,
+// 충격량 솔버처럼 여러 패스에 걸쳐 겹침을 조금씩 밀어내지 않으므로 높이 쌓인 더미도 가라앉지 않는다.
+//
+// 제약은 공끼리(|xb - xa| >= ra + rb), 공과 상자 벽, 공과 장애물(접촉 시점의 평면으로 근사)이다.
+// Compliance가 0이면 단단한 제약(PBD)이고, 키우면 스텝 길이와 관계없이 같은 만큼 물렁해진다.
+// 반복은 접촉 순서대로 바로 고치는 Gauss-Seidel(직렬)과, 모든 접촉의 보정을 모아 평균 내는 Jacobi(병렬) 중에서 고른다.
+class FPositionSolver
+{
+public:
+    int Iterations = 4;              // 서브스텝마다 위치 반복 횟수 (항상 이만큼 돈다)
+    bool Jacobi = false;             // true면 Jacobi, false면 Gauss-Seidel
+    float JacobiRelaxation = 1.5f;   // Jacobi에서 평균 낸 보정에 곱하는 값 (1보다 크면 빨리 수렴하지만 너무 크면 떨린다)
+    float Compliance = 0.0f;         // 공끼리 접촉의 물렁함 (역강성)
+    float StaticCompliance = 0.0f;   // 벽과 장애물 접촉의 물렁함
+    float RestitutionThreshold = 0.25f; // 이보다 느리게 부딪히면 튕기지 않는다 (FContactSolver와 같은 값)
+
+    // 마지막 Solve의 통계
+    int NumConstraints = 0;
+    float MaxError = 0.0f; // 반복이 끝난 뒤 남은 가장 큰 겹침
+
+    // 1. 시작 위치를 저장하고 깨어 있는 공의 속도와 위치를 dt만큼 예측한다 (벽은 Solve에서 제약으로 푼다)
+    void Predict(FBallWorld& world, float dt, float gravityY, FJobSystem& jobs)
+    {
+        const int count = world.Count;
+        StartX.resize(count);
+        StartY.resize(count);
+        StartZ.resize(count);
+        if (count > 0)
+        {
+            memcpy(StartX.data(), world.PosX, sizeof(float) * count);
+            memcpy(StartY.data(), world.PosY, sizeof(float) * count);
+            memcpy(StartZ.data(), world.PosZ, sizeof(float) * count);
+        }
+
+        const std::vector<int>& awake = world.GetAwakeBalls();
+        const int* indices = awake.data();
+        jobs.ParallelFor((int)awake.size(), BallGrain, [&world, indices, dt, gravityY](int, int begin, int end)
+        {
+            for (int k = begin; k < end; k++)
+            {
+                const int i = indices[k];
+                world.VelY[i] += gravityY * dt;
+                world.PosX[i] += world.VelX[i] * dt;
+                world.PosY[i] += world.VelY[i] * dt;
+                world.PosZ[i] += world.VelZ[i] * dt;
+            }
+        });
+    }
+
+    // 2. 예측한 위치에서 찾은 후보 쌍과 장애물 접촉으로 제약을 풀고, 움직인 거리로 속도를 다시 구한 뒤 튕김을 준다
+    // 공끼리는 아직 겹치지 않은 후보 쌍(AABB가 겹친 쌍)도 제약으로 넣어, 반복 중에 밀려서 새로 겹치는 공도 같이 푼다
+    void Solve(FBallWorld& world, const FCollisionPair* pairs, int numPairs,
+        const FObstacleContact* obstacleContacts, int numObstacleContacts, float dt, FJobSystem& jobs)
+    {
+        BuildConstraints(world, pairs, numPairs, obstacleContacts, numObstacleContacts);
+
+        const float alpha = Compliance / (dt * dt);
+        const float staticAlpha = StaticCompliance / (dt * dt);
+        for (int iteration = 0; iteration < Iterations; iteration++)
+        {
+            if (Jacobi)
+                IterateJacobi(world, alpha, staticAlpha, jobs);
+            else
+                IterateGaussSeidel(world, alpha, staticAlpha);
+        }
+
+        MaxError = 0.0f;
+        for (const FConstraint& constraint : Constraints)
+            MaxError = std::max(MaxError, Evaluate(world, constraint));
+
+        DeriveVelocities(world, dt, jobs);
+        SolveVelocities(world);
+    }
+
+private:
+    static const int BallGrain = 4096;
+    static const int ConstraintGrain = 2048;
+
+    struct FConstraint
+    {
+        int A;
+        int B;           // 벽이나 장애물이면 -1
+        float NormalX;   // A에서 B(또는 벽/장애물)를 향하는 방향 (공끼리는 반복마다 다시 구한다)
+        float NormalY;
+        float NormalZ;
+        float Distance;  // 공끼리는 반지름 합, 벽/장애물은 평면 위치 (n·x가 이보다 크면 겹침)
+        float Lambda;    // 누적 라그랑주 승수 (위치 보정량)
+        float NormalVelocity; // 풀기 전 법선 방향 상대 속도 (B - A, 음수면 다가옴)
+        float Restitution;
+        float DeltaX;    // Jacobi: 이번 반복의 A 쪽 보정 (B는 반대 방향으로 비율만큼)
+        float DeltaY;
+        float DeltaZ;
+        float DeltaLambda;
+    };
+
+    void BuildConstraints(FBallWorld& world, const FCollisionPair* pairs, int numPairs,
+        const FObstacleContact* obstacleContacts, int numObstacleContacts)
+    {
+        Constraints.clear();
+        for (int p = 0; p < numPairs; p++)
+        {
+            const int a = pairs[p].A;
+            const int b = pairs[p].B;
+            FConstraint constraint = {};
+            constraint.A = a;
+            constraint.B = b;
+            constraint.NormalX = 1.0f; // 완전히 겹친 쌍이 쓸 아무 방향
+            constraint.Distance = world.Radius[a] + world.Radius[b];
+            float normal[3];
+            Evaluate(world, constraint, normal);
+            constraint.NormalX = normal[0];
+            constraint.NormalY = normal[1];
+            constraint.NormalZ = normal[2];
+            constraint.Restitution = world.Restitution;
+            constraint.NormalVelocity = NormalVelocity(world, constraint);
+            Constraints.push_back(constraint);
+        }
+
+        // 상자 벽: 벽에서 반지름 안쪽까지 온 공만 (반복 중에 밀려 들어가도 잡히도록 여유를 둔다)
+        const std::vector<int>& awake = world.GetAwakeBalls();
+        for (int i : awake)
+        {
+            const float r = world.Radius[i];
+            const float limit = 1.0f - 2.0f * r;
+            const float position[3] = { world.PosX[i], world.PosY[i], world.PosZ[i] };
+            for (int axis = 0; axis < 3; axis++)
+            {
+                if (position[axis] < -limit) AddStaticConstraint(world, i, axis, -1.0f, 1.0f - r, world.WallRestitution);
+                if (position[axis] > limit) AddStaticConstraint(world, i, axis, 1.0f, 1.0f - r, world.WallRestitution);
+            }
+        }
+
+        // 장애물과 용기: 접촉 시점의 접평면 (공이 n 방향으로 Penetration만큼 덜 가야 한다)
+        for (int c = 0; c < numObstacleContacts; c++)
+        {
+            const FObstacleContact& contact = obstacleContacts[c];
+            const int i = contact.Ball;
+            FConstraint constraint = {};
+            constraint.A = i;
+            constraint.B = -1;
+            constraint.NormalX = contact.NormalX;
+            constraint.NormalY = contact.NormalY;
+            constraint.NormalZ = contact.NormalZ;
+            constraint.Distance = contact.NormalX * world.PosX[i] + contact.NormalY * world.PosY[i] + contact.NormalZ * world.PosZ[i] - contact.Penetration;
+            constraint.Restitution = world.Restitution;
+            constraint.NormalVelocity = NormalVelocity(world, constraint);
+            Constraints.push_back(constraint);
+        }
+
+        NumConstraints = (int)Constraints.size();
+    }
+
+    void AddStaticConstraint(const FBallWorld& world, int i, int axis, float sign, float distance, float restitution)
+    {
+        FConstraint constraint = {};
+        constraint.A = i;
+        constraint.B = -1;
+        constraint.NormalX = axis == 0 ? sign : 0.0f;
+        constraint.NormalY = axis == 1 ? sign : 0.0f;
+        constraint.NormalZ = axis == 2 ? sign : 0.0f;
+        constraint.Distance = distance;
+        constraint.Restitution = restitution;
+        constraint.NormalVelocity = NormalVelocity(world, constraint);
+        Constraints.push_back(constraint);
+    }
+
+    // 현재 위치에서 제약이 어긋난 정도 (양수면 겹침). 공끼리는 법선도 다시 구한다
+    static float Evaluate(const FBallWorld& world, const FConstraint& constraint, float* outNormal = nullptr)
+    {
+        const int a = constraint.A;
+        const int b = constraint.B;
+        if (b < 0)
+        {
+            if (outNormal)
+            {
+                outNormal[0] = constraint.NormalX;
+                outNormal[1] = constraint.NormalY;
+                outNormal[2] = constraint.NormalZ;
+            }
+            return constraint.NormalX * world.PosX[a] + constraint.NormalY * world.PosY[a] + constraint.NormalZ * world.PosZ[a] - constraint.Distance;
+        }
+
+        const float dx = world.PosX[b] - world.PosX[a];
+        const float dy = world.PosY[b] - world.PosY[a];
+        const float dz = world.PosZ[b] - world.PosZ[a];
+        const float distance = sqrtf(dx * dx + dy * dy + dz * dz);
+        if (outNormal)
+        {
+            // 완전히 겹친 공은 접촉을 찾을 때의 법선을 그대로 쓴다
+            const bool bValid = distance > 1e-6f;
+            outNormal[0] = bValid ? dx / distance : constraint.NormalX;
+            outNormal[1] = bValid ? dy / distance : constraint.NormalY;
+            outNormal[2] = bValid ? dz / distance : constraint.NormalZ;
+        }
+        return constraint.Distance - distance;
+    }
+
+    // 제약 하나의 승수 변화량 (접촉은 밀어내기만 하므로 겹치지 않았으면 0)
+    static float ComputeDeltaLambda(const FBallWorld& world, const FConstraint& constraint, float error, float alpha)
+    {
+        if (error <= 0.0f) return 0.0f;
+
+        const float invMassB = constraint.B >= 0 ? world.InvMass[constraint.B] : 0.0f;
+        const float denominator = world.InvMass[constraint.A] + invMassB + alpha;
+        if (denominator <= 0.0f) return 0.0f; // 둘 다 잠든 공
+
+        const float deltaLambda = (error - alpha * constraint.Lambda) / denominator;
+        return std::max(deltaLambda, -constraint.Lambda);
+    }
+
+    void IterateGaussSeidel(FBallWorld& world, float alpha, float staticAlpha)
+    {
+        for (FConstraint& constraint : Constraints)
+        {
+            float normal[3];
+            const float error = Evaluate(world, constraint, normal);
+            const float deltaLambda = ComputeDeltaLambda(world, constraint, error, constraint.B >= 0 ? alpha : staticAlpha);
+            if (deltaLambda == 0.0f) continue;
+            constraint.Lambda += deltaLambda;
+
+            const int a = constraint.A;
+            const float moveA = world.InvMass[a] * deltaLambda;
+            world.PosX[a] -= normal[0] * moveA; world.PosY[a] -= normal[1] * moveA; world.PosZ[a] -= normal[2] * moveA;
+
+            const int b = constraint.B;
+            if (b < 0) continue;
+            const float moveB = world.InvMass[b] * deltaLambda;
+            world.PosX[b] += normal[0] * moveB; world.PosY[b] += normal[1] * moveB; world.PosZ[b] += normal[2] * moveB;
+        }
+    }
+
+    // 모든 제약의 보정을 같은 위치에서 병렬로 구하고, 공마다 모아 제약 수로 나눈 평균만큼 옮긴다
+    void IterateJacobi(FBallWorld& world, float alpha, float staticAlpha, FJobSystem& jobs)
+    {
+        const int numConstraints = (int)Constraints.size();
+        jobs.ParallelFor(numConstraints, ConstraintGrain, [this, &world, alpha, staticAlpha](int, int begin, int end)
+        {
+            for (int c = begin; c < end; c++)
+            {
+                FConstraint& constraint = Constraints[c];
+                float normal[3];
+                const float error = Evaluate(world, constraint, normal);
+                constraint.DeltaLambda = ComputeDeltaLambda(world, constraint, error, constraint.B >= 0 ? alpha : staticAlpha);
+                constraint.Lambda += constraint.DeltaLambda;
+                constraint.DeltaX = normal[0] * constraint.DeltaLambda;
+                constraint.DeltaY = normal[1] * constraint.DeltaLambda;
+                constraint.DeltaZ = normal[2] * constraint.DeltaLambda;
+            }
+        });
+
+        // 접촉 순서대로 모으므로 스레드 수와 관계없이 결과가 같다
+        const int count = world.Count;
+        AccumX.assign(count, 0.0f);
+        AccumY.assign(count, 0.0f);
+        AccumZ.assign(count, 0.0f);
+        AccumCount.assign(count, 0);
+        for (const FConstraint& constraint : Constraints)
+        {
+            if (constraint.DeltaLambda == 0.0f) continue;
+
+            const int a = constraint.A;
+            const float weightA = world.InvMass[a];
+            AccumX[a] -= constraint.DeltaX * weightA; AccumY[a] -= constraint.DeltaY * weightA; AccumZ[a] -= constraint.DeltaZ * weightA;
+            AccumCount[a]++;
+
+            const int b = constraint.B;
+            if (b < 0) continue;
+            const float weightB = world.InvMass[b];
+            AccumX[b] += constraint.DeltaX * weightB; AccumY[b] += constraint.DeltaY * weightB; AccumZ[b] += constraint.DeltaZ * weightB;
+            AccumCount[b]++;
+        }
+
+        const float relaxation = JacobiRelaxation;
+        jobs.ParallelFor(count, BallGrain, [this, &world, relaxation](int, int begin, int end)
+        {
+            for (int i = begin; i < end; i++)
+            {
+                if (AccumCount[i] == 0) continue;
+                const float scale = relaxation / AccumCount[i];
+                world.PosX[i] += AccumX[i] * scale;
+                world.PosY[i] += AccumY[i] * scale;
+                world.PosZ[i] += AccumZ[i] * scale;
+            }
+        });
+    }
+
+    // 3. 상자 밖으로 밀려난 공을 되돌리고, 스텝 동안 움직인 거리로 속도를 구한다
+    void DeriveVelocities(FBallWorld& world, float dt, FJobSystem& jobs)
+    {
+        const std::vector<int>& awake = world.GetAwakeBalls();
+        const int* indices = awake.data();
+        const float invDt = 1.0f / dt;
+        jobs.ParallelFor((int)awake.size(), BallGrain, [this, &world, indices, invDt](int, int begin, int end)
+        {
+            for (int k = begin; k < end; k++)
+            {
+                const int i = indices[k];
+                const float limit = 1.0f - world.Radius[i];
+                world.PosX[i] = std::min(std::max(world.PosX[i], -limit), limit);
+                world.PosY[i] = std::min(std::max(world.PosY[i], -limit), limit);
+                world.PosZ[i] = std::min(std::max(world.PosZ[i], -limit), limit);
+                world.VelX[i] = (world.PosX[i] - StartX[i]) * invDt;
+                world.VelY[i] = (world.PosY[i] - StartY[i]) * invDt;
+                world.VelZ[i] = (world.PosZ[i] - StartZ[i]) * invDt;
+            }
+        });
+    }
+
+    // 4. 풀린 접촉의 법선 속도를 튕김 속도(빠르게 부딪혔으면) 또는 0으로 맞춘다
+    // 위치 보정이 만든 떨어지는 속도도 함께 없애서, 쌓인 공이 보정 때문에 튀어 오르지 않는다
+    void SolveVelocities(FBallWorld& world) const
+    {
+        for (const FConstraint& constraint : Constraints)
+        {
+            if (constraint.Lambda <= 0.0f) continue; // 반복 동안 한 번도 닿지 않았음
+
+            const int a = constraint.A;
+            const int b = constraint.B;
+            const float invMassA = world.InvMass[a];
+            const float invMassB = b >= 0 ? world.InvMass[b] : 0.0f;
+            const float totalInvMass = invMassA + invMassB;
+            if (totalInvMass <= 0.0f) continue;
+
+            float normal[3];
+            Evaluate(world, constraint, normal);
+            float velocity = -(world.VelX[a] * normal[0] + world.VelY[a] * normal[1] + world.VelZ[a] * normal[2]);
+            if (b >= 0)
+                velocity += world.VelX[b] * normal[0] + world.VelY[b] * normal[1] + world.VelZ[b] * normal[2];
+
+            const float target = constraint.NormalVelocity < -RestitutionThreshold ? -constraint.Restitution * constraint.NormalVelocity : 0.0f;
+            const float change = (target - velocity) / totalInvMass;
+            world.VelX[a] -= normal[0] * change * invMassA; world.VelY[a] -= normal[1] * change * invMassA; world.VelZ[a] -= normal[2] * change * invMassA;
+            if (b < 0) continue;
+            world.VelX[b] += normal[0] * change * invMassB; world.VelY[b] += normal[1] * change * invMassB; world.VelZ[b] += normal[2] * change * invMassB;
+        }
+    }
+
+    // 법선 방향 상대 속도 (B의 속도 - A의 속도, 벽과 장애물은 속도 0)
+    static float NormalVelocity(const FBallWorld& world, const FConstraint& constraint)
+    {
+        const int a = constraint.A;
+        const int b = constraint.B;
+        float velocity = -(world.VelX[a] * constraint.NormalX + world.VelY[a] * constraint.NormalY + world.VelZ[a] * constraint.NormalZ);
+        if (b >= 0)
+            velocity += world.VelX[b] * constraint.NormalX + world.VelY[b] * constraint.NormalY + world.VelZ[b] * constraint.NormalZ;
+        return velocity;
+    }
+
+    std::vector<FConstraint> Constraints;
+    std::vector<float> StartX, StartY, StartZ; // Predict 직전 위치 (속도를 다시 구할 때 쓴다)
+    std::vector<float> AccumX, AccumY, AccumZ; // Jacobi 보정 합
+    std::vector<int> AccumCount;
+};
@@ -0,0 +1,555 @@
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+#include <cassert>
+#include <cfloat>
+#include <algorithm>
+#include <vector>
+
+#include "Vector.h"
+
+class URenderer;
+
+// 도형 종류 태그 (충돌 함수 표의 인덱스)
+// 기본 도형은 여기에 있고, 새 도형은 FCollisionDispatcher::AllocateShapeType으로 번호를 받아 기존 코드를 고치지 않고 붙인다.
+enum EShapeType
+{
+    Shape_Sphere,
+    Shape_Plane,
+    Shape_Box,
+    Shape_Capsule,
+    Shape_ConvexPolygon,
+    Shape_NumBuiltIn,
+};
+
+// 두 도형의 접촉 (법선은 A에서 B를 향하고, Penetration은 겹친 깊이)
+struct FShapeContact
+{
+    FVector Normal;
+    FVector Point;
+    float Penetration = 0.0f;
+};
+
+// 공 이외의 도형을 위한 인터페이스 (공은 FBallWorld가 배열로 관리)
+// 충돌 검사는 가상 함수나 dynamic_cast 대신 두 도형의 종류 태그로 FCollisionDispatcher의 표에서 함수를 찾는다.
+class UPrimitive
+{
+public:
+    explicit UPrimitive(int shapeType)
+        : ShapeType(shapeType)
+    {
+    }
+
+    virtual ~UPrimitive() {}
+
+    int GetShapeType() const { return ShapeType; }
+
+    // 움직이지 않는 도형은 Update/Render를 재정의하지 않아도 된다
+    virtual void Update(float /*t*/) {}
+    virtual void Render(URenderer& /*renderer*/) {}
+    virtual void Translate(const FVector& v) = 0;
+
+    // 도형을 감싸는 AABB (끝없는 도형이면 false를 반환하고 채우지 않는다)
+    virtual bool GetBounds(FVector& outMin, FVector& outMax) const = 0;
+
+    // 화면에 외곽선을 그릴 선분의 양 끝점을 두 개씩 덧붙인다
+    virtual void GetOutline(std::vector<FVector>& /*outLines*/) const {}
+
+    // 두 도형이 겹치는지 검사한다 (outContact가 있으면 접촉 정보를 채운다)
+    bool Collision(const UPrimitive* other, FShapeContact* outContact = nullptr) const;
+
+private:
+    int ShapeType;
+};
+
+// 구 (공 하나를 도형 검사에 넘길 때도 스택에 만들어 쓴다)
+class USphere : public UPrimitive
+{
+public:
+    FVector Center;
+    float Radius;
+
+    USphere(const FVector& center = FVector(), float radius = 0.0f)
+        : UPrimitive(Shape_Sphere), Center(center), Radius(radius)
+    {
+    }
+
+    void Translate(const FVector& v) override { Center += v; }
+
+    bool GetBounds(FVector& outMin, FVector& outMax) const override
+    {
+        const FVector extent(Radius, Radius, Radius);
+        outMin = Center - extent;
+        outMax = Center + extent;
+        return true;
+    }
+};
+
+// 무한 평면 (Normal 쪽이 빈 공간, 반대쪽이 막힌 공간). Normal · x = Distance 인 점들
+class UPlane : public UPrimitive
+{
+public:
+    FVector Normal;
+    float Distance;
+
+    UPlane(const FVector& normal = FVector(0.0f, 1.0f, 0.0f), float distance = 0.0f)
+        : UPrimitive(Shape_Plane), Normal(normal.GetSafeNormal()), Distance(distance)
+    {
+    }
+
+    void Translate(const FVector& v) override { Distance += Normal.Dot(v); }
+
+    bool GetBounds(FVector& /*outMin*/, FVector& /*outMax*/) const override { return false; }
+
+    // z = 0 단면에서 [-1, 1] 상자를 가로지르는 선분
+    void GetOutline(std::vector<FVector>& outLines) const override
+    {
+        const FVector base = Normal * Distance;
+        const FVector tangent(-Normal.y, Normal.x, 0.0f);
+        if (tangent.SizeSquared() < 1e-6f) return;
+        outLines.push_back(base - tangent * 3.0f);
+        outLines.push_back(base + tangent * 3.0f);
+    }
+};
+
+// 회전된 상자 (중심, 서로 수직인 단위 축 3개, 축마다 반 길이)
+class UBox : public UPrimitive
+{
+public:
+    FVector Center;
+    FVector Axis[3];
+    FVector HalfExtent;
+
+    UBox(const FVector& center = FVector(), const FVector& halfExtent = FVector(0.5f, 0.5f, 0.5f))
+        : UPrimitive(Shape_Box), Center(center), HalfExtent(halfExtent)
+    {
+        Axis[0] = FVector(1.0f, 0.0f, 0.0f);
+        Axis[1] = FVector(0.0f, 1.0f, 0.0f);
+        Axis[2] = FVector(0.0f, 0.0f, 1.0f);
+    }
+
+    // z축을 기준으로 angle(라디안)만큼 돌린 축으로 바꾼다 (2D 장면에서 기울어진 상자)
+    void SetRotationZ(float angle)
+    {
+        const float c = cosf(angle);
+        const float s = sinf(angle);
+        Axis[0] = FVector(c, s, 0.0f);
+        Axis[1] = FVector(-s, c, 0.0f);
+        Axis[2] = FVector(0.0f, 0.0f, 1.0f);
+    }
+
+    void Translate(const FVector& v) override { Center += v; }
+
+    bool GetBounds(FVector& outMin, FVector& outMax) const override
+    {
+        FVector extent;
+        for (int k = 0; k < 3; k++)
+        {
+            const float half = k == 0 ? HalfExtent.x : (k == 1 ? HalfExtent.y : HalfExtent.z);
+            extent += FVector(fabsf(Axis[k].x), fabsf(Axis[k].y), fabsf(Axis[k].z)) * half;
+        }
+        outMin = Center - extent;
+        outMax = Center + extent;
+        return true;
+    }
+
+    // 모서리 12개
+    void GetOutline(std::vector<FVector>& outLines) const override
+    {
+        FVector corners[8];
+        for (int c = 0; c < 8; c++)
+        {
+            corners[c] = Center
+                + Axis[0] * ((c & 1) ? HalfExtent.x : -HalfExtent.x)
+                + Axis[1] * ((c & 2) ? HalfExtent.y : -HalfExtent.y)
+                + Axis[2] * ((c & 4) ? HalfExtent.z : -HalfExtent.z);
+        }
+        for (int c = 0; c < 8; c++)
+        {
+            for (int bit = 1; bit < 8; bit <<= 1)
+            {
+                if (c & bit) continue;
+                outLines.push_back(corners[c]);
+                outLines.push_back(corners[c | bit]);
+            }
+        }
+    }
+};
+
+// 캡슐 (선분 Start-End에서 Radius 안의 점들)
+class UCapsule : public UPrimitive
+{
+public:
+    FVector Start;
+    FVector End;
+    float Radius;
+
+    UCapsule(const FVector& start = FVector(), const FVector& end = FVector(), float radius = 0.0f)
+        : UPrimitive(Shape_Capsule), Start(start), End(end), Radius(radius)
+    {
+    }
+
+    // 선분 위에서 point에 가장 가까운 점
+    FVector GetClosestPoint(const FVector& point) const
+    {
+        const FVector segment = End - Start;
+        const float lengthSq = segment.SizeSquared();
+        const float t = lengthSq > 1e-12f ? std::min(std::max((point - Start).Dot(segment) / lengthSq, 0.0f), 1.0f) : 0.0f;
+        return Start + segment * t;
+    }
+
+    void Translate(const FVector& v) override { Start += v; End += v; }
+
+    bool GetBounds(FVector& outMin, FVector& outMax) const override
+    {
+        outMin = FVector(std::min(Start.x, End.x) - Radius, std::min(Start.y, End.y) - Radius, std::min(Start.z, End.z) - Radius);
+        outMax = FVector(std::max(Start.x, End.x) + Radius, std::max(Start.y, End.y) + Radius, std::max(Start.z, End.z) + Radius);
+        return true;
+    }
+
+    // z = 0 단면: 양옆 직선과 양 끝 반원
+    void GetOutline(std::vector<FVector>& outLines) const override
+    {
+        FVector forward = FVector(End.x - Start.x, End.y - Start.y, 0.0f).GetSafeNormal();
+        if (forward.SizeSquared() == 0.0f) forward = FVector(1.0f, 0.0f, 0.0f);
+        const FVector side(-forward.y, forward.x, 0.0f);
+        outLines.push_back(Start + side * Radius); outLines.push_back(End + side * Radius);
+        outLines.push_back(Start - side * Radius); outLines.push_back(End - side * Radius);
+
+        const int numArcSegments = 8;
+        for (int k = 0; k < numArcSegments; k++)
+        {
+            const float a0 = 3.14159265f * k / numArcSegments;
+            const float a1 = 3.14159265f * (k + 1) / numArcSegments;
+            // End 쪽 반원은 side에서 forward를 거쳐 -side로, Start 쪽은 그 반대편
+            outLines.push_back(End + (side * cosf(a0) + forward * sinf(a0)) * Radius);
+            outLines.push_back(End + (side * cosf(a1) + forward * sinf(a1)) * Radius);
+            outLines.push_back(Start + (side * cosf(a0) - forward * sinf(a0)) * Radius);
+            outLines.push_back(Start + (side * cosf(a1) - forward * sinf(a1)) * Radius);
+        }
+    }
+};
+
+// 볼록 다각형을 z 방향으로 HalfDepth만큼 늘인 기둥 (꼭짓점은 xy 평면에 반시계 방향)
+// 꼭짓점 배열을 도형 안에 고정 크기로 두어서 풀에서 만들 때 힙 할당이 없다.
+class UConvexPolygon : public UPrimitive
+{
+public:
+    static const int MaxVertices = 16;
+
+    FVector Vertices[MaxVertices]; // z는 무시
+    FVector EdgeNormals[MaxVertices]; // 변 i (Vertices[i] -> Vertices[i + 1])의 바깥쪽 단위 법선
+    int NumVertices = 0;
+    float HalfDepth;
+
+    UConvexPolygon(const FVector* vertices = nullptr, int numVertices = 0, float halfDepth = 1.0f)
+        : UPrimitive(Shape_ConvexPolygon), HalfDepth(halfDepth)
+    {
+        SetVertices(vertices, numVertices);
+    }
+
+    // 꼭짓점을 바꾸고 변 법선을 다시 계산한다 (MaxVertices를 넘는 꼭짓점은 버린다)
+    void SetVertices(const FVector* vertices, int numVertices)
+    {
+        NumVertices = std::min(std::max(numVertices, 0), (int)MaxVertices);
+        for (int i = 0; i < NumVertices; i++)
+            Vertices[i] = FVector(vertices[i].x, vertices[i].y, 0.0f);
+        UpdateEdgeNormals();
+    }
+
+    void Translate(const FVector& v) override
+    {
+        for (int i = 0; i < NumVertices; i++)
+        {
+            Vertices[i].x += v.x;
+            Vertices[i].y += v.y;
+        }
+    }
+
+    bool GetBounds(FVector& outMin, FVector& outMax) const override
+    {
+        if (NumVertices == 0) return false;
+        outMin = FVector(Vertices[0].x, Vertices[0].y, -HalfDepth);
+        outMax = FVector(Vertices[0].x, Vertices[0].y, HalfDepth);
+        for (int i = 1; i < NumVertices; i++)
+        {
+            outMin.x = std::min(outMin.x, Vertices[i].x); outMax.x = std::max(outMax.x, Vertices[i].x);
+            outMin.y = std::min(outMin.y, Vertices[i].y); outMax.y = std::max(outMax.y, Vertices[i].y);
+        }
+        return true;
+    }
+
+    // 앞뒤 면의 변과 그 사이를 잇는 모서리 (2D 모드에서는 앞뒤가 겹쳐 보인다)
+    void GetOutline(std::vector<FVector>& outLines) const override
+    {
+        for (int i = 0; i < NumVertices; i++)
+        {
+            const FVector& a = Vertices[i];
+            const FVector& b = Vertices[(i + 1) % NumVertices];
+            outLines.push_back(FVector(a.x, a.y, -HalfDepth)); outLines.push_back(FVector(b.x, b.y, -HalfDepth));
+            outLines.push_back(FVector(a.x, a.y, HalfDepth));  outLines.push_back(FVector(b.x, b.y, HalfDepth));
+            outLines.push_back(FVector(a.x, a.y, -HalfDepth)); outLines.push_back(FVector(a.x, a.y, HalfDepth));
+        }
+    }
+
+private:
+    void UpdateEdgeNormals()
+    {
+        for (int i = 0; i < NumVertices; i++)
+        {
+            const FVector edge = Vertices[(i + 1) % NumVertices] - Vertices[i];
+            EdgeNormals[i] = FVector(edge.y, -edge.x, 0.0f).GetSafeNormal();
+        }
+    }
+};
+
+// 도형 종류 쌍마다 충돌 함수를 담은 표
+// Register(A, B, f)로 등록하면 (B, A) 칸은 인자를 바꿔 부르고 법선을 뒤집는 방식으로 함께 채워진다.
+class FCollisionDispatcher
+{
+public:
+    typedef bool (*FCollideFunc)(const UPrimitive& a, const UPrimitive& b, FShapeContact* outContact);
+
+    static const int MaxShapeTypes = 16;
+
+    static FCollisionDispatcher& Get()
+    {
+        static FCollisionDispatcher instance;
+        return instance;
+    }
+
+    // 기본 도형 다음부터 새 도형 종류 번호를 나눠 준다.
+    // MaxShapeTypes개를 다 쓰면 -1을 돌려준다. 이 값은 Register가 거부하고 Collide는 늘 겹치지 않음으로 보므로,
+    // 부르는 쪽은 -1이면 그 도형을 만들지 말아야 한다 (만들어도 아무것과도 부딪히지 않는다)
+    int AllocateShapeType()
+    {
+        return NumShapeTypes < MaxShapeTypes ? NumShapeTypes++ : -1;
+    }
+
+    // 두 종류 모두 이미 나눠 준 번호여야 한다. 아니면 (AllocateShapeType이 준 -1 포함) 표를 건드리지 않고 false
+    bool Register(int typeA, int typeB, FCollideFunc func)
+    {
+        const bool bValid = IsValidType(typeA) && IsValidType(typeB);
+        assert(bValid && "Register: shape type was not allocated");
+        if (!bValid) return false;
+
+        Table[typeA][typeB] = { func, false };
+        if (typeA != typeB)
+            Table[typeB][typeA] = { func, true };
+        return true;
+    }
+
+    // 등록되지 않은 종류 쌍은 겹치지 않는 것으로 본다
+    bool Collide(const UPrimitive& a, const UPrimitive& b, FShapeContact* outContact) const
+    {
+        if (!IsValidType(a.GetShapeType()) || !IsValidType(b.GetShapeType())) return false;
+        const FEntry& entry = Table[a.GetShapeType()][b.GetShapeType()];
+        if (!entry.Func) return false;
+        if (!entry.bSwapped) return entry.Func(a, b, outContact);
+
+        if (!entry.Func(b, a, outContact)) return false;
+        if (outContact) outContact->Normal = outContact->Normal * -1.0f;
+        return true;
+    }
+
+private:
+    struct FEntry
+    {
+        FCollideFunc Func;
+        bool bSwapped; // 등록된 함수의 인자 순서가 반대인 칸
+    };
+
+    FEntry Table[MaxShapeTypes][MaxShapeTypes] = {};
+    int NumShapeTypes = Shape_NumBuiltIn;
+
+    bool IsValidType(int type) const
+    {
+        return type >= 0 && type < NumShapeTypes;
+    }
+
+    FCollisionDispatcher()
+    {
+        Register(Shape_Sphere, Shape_Sphere, &CollideSphereSphere);
+        Register(Shape_Sphere, Shape_Plane, &CollideSpherePlane);
+        Register(Shape_Sphere, Shape_Box, &CollideSphereBox);
+        Register(Shape_Sphere, Shape_Capsule, &CollideSphereCapsule);
+        Register(Shape_Sphere, Shape_ConvexPolygon, &CollideSphereConvexPolygon);
+    }
+
+    // 아래 함수들은 종류가 맞는 것이 표에서 보장되므로 static_cast로 바로 내려간다
+
+    static bool CollideSphereSphere(const UPrimitive& a, const UPrimitive& b, FShapeContact* outContact)
+    {
+        const USphere& sa = static_cast<const USphere&>(a);
+        const USphere& sb = static_cast<const USphere&>(b);
+        const FVector delta = sb.Center - sa.Center;
+        const float reach = sa.Radius + sb.Radius;
+        const float distanceSq = delta.SizeSquared();
+        if (distanceSq >= reach * reach) return false;
+
+        if (outContact)
+        {
+            const float distance = sqrtf(distanceSq);
+            outContact->Normal = distance > 1e-6f ? delta * (1.0f / distance) : FVector(1.0f, 0.0f, 0.0f);
+            outContact->Penetration = reach - distance;
+            outContact->Point = sa.Center + outContact->Normal * (sa.Radius - outContact->Penetration * 0.5f);
+        }
+        return true;
+    }
+
+    static bool CollideSpherePlane(const UPrimitive& a, const UPrimitive& b, FShapeContact* outContact)
+    {
+        const USphere& sphere = static_cast<const USphere&>(a);
+        const UPlane& plane = static_cast<const UPlane&>(b);
+        const float distance = plane.Normal.Dot(sphere.Center) - plane.Distance;
+        if (distance >= sphere.Radius) return false;
+
+        if (outContact)
+        {
+            outContact->Normal = plane.Normal * -1.0f; // 구에서 평면 안쪽으로
+            outContact->Penetration = sphere.Radius - distance;
+            outContact->Point = sphere.Center - plane.Normal * distance;
+        }
+        return true;
+    }
+
+    // 상자의 지역 좌표에서 구 중심에 가장 가까운 점을 찾는다 (중심이 상자 안이면 가장 가까운 면으로 밀어낸다)
+    static bool CollideSphereBox(const UPrimitive& a, const UPrimitive& b, FShapeContact* outContact)
+    {
+        const USphere& sphere = static_cast<const USphere&>(a);
+        const UBox& box = static_cast<const UBox&>(b);
+        const FVector delta = sphere.Center - box.Center;
+        const float local[3] = { delta.Dot(box.Axis[0]), delta.Dot(box.Axis[1]), delta.Dot(box.Axis[2]) };
+        const float half[3] = { box.HalfExtent.x, box.HalfExtent.y, box.HalfExtent.z };
+
+        float closest[3];
+        bool bInside = true;
+        for (int k = 0; k < 3; k++)
+        {
+            closest[k] = std::min(std::max(local[k], -half[k]), half[k]);
+            if (closest[k] != local[k]) bInside = false;
+        }
+
+        if (!bInside)
+        {
+            const FVector closestPoint = box.Center + box.Axis[0] * closest[0] + box.Axis[1] * closest[1] + box.Axis[2] * closest[2];
+            const FVector toBox = closestPoint - sphere.Center;
+            const float distanceSq = toBox.SizeSquared();
+            if (distanceSq >= sphere.Radius * sphere.Radius) return false;
+
+            if (outContact)
+            {
+                const float distance = sqrtf(distanceSq);
+                outContact->Normal = distance > 1e-6f ? toBox * (1.0f / distance) : box.Axis[0];
+                outContact->Penetration = sphere.Radius - distance;
+                outContact->Point = closestPoint;
+            }
+            return true;
+        }
+
+        if (outContact)
+        {
+            // 면까지 남은 거리가 가장 짧은 축으로 밀어낸다
+            int axis = 0;
+            float minGap = half[0] - fabsf(local[0]);
+            for (int k = 1; k < 3; k++)
+            {
+                const float gap = half[k] - fabsf(local[k]);
+                if (gap < minGap) { minGap = gap; axis = k; }
+            }
+            const FVector outward = box.Axis[axis] * (local[axis] >= 0.0f ? 1.0f : -1.0f);
+            outContact->Normal = outward * -1.0f;
+            outContact->Penetration = sphere.Radius + minGap;
+            outContact->Point = sphere.Center + outward * minGap;
+        }
+        return true;
+    }
+
+    // 캡슐 = 선분에서 가장 가까운 점을 중심으로 한 구
+    static bool CollideSphereCapsule(const UPrimitive& a, const UPrimitive& b, FShapeContact* outContact)
+    {
+        const USphere& sphere = static_cast<const USphere&>(a);
+        const UCapsule& capsule = static_cast<const UCapsule&>(b);
+        return CollideSphereSphere(sphere, USphere(capsule.GetClosestPoint(sphere.Center), capsule.Radius), outContact);
+    }
+
+    // xy 단면의 볼록 다각형과 z 범위로 기둥에서 가장 가까운 점을 찾는다 (중심이 안이면 가장 가까운 면으로 밀어낸다)
+    static bool CollideSphereConvexPolygon(const UPrimitive& a, const UPrimitive& b, FShapeContact* outContact)
+    {
+        const USphere& sphere = static_cast<const USphere&>(a);
+        const UConvexPolygon& polygon = static_cast<const UConvexPolygon&>(b);
+        if (polygon.NumVertices < 3) return false;
+
+        const FVector& center = sphere.Center;
+        const float z = std::min(std::max(center.z, -polygon.HalfDepth), polygon.HalfDepth);
+
+        // 가장 바깥쪽에 있는 변 (모든 변 안쪽이면 xy 단면 안)
+        int maxEdge = 0;
+        float maxSeparation = -FLT_MAX;
+        for (int i = 0; i < polygon.NumVertices; i++)
+        {
+            const float separation = polygon.EdgeNormals[i].Dot(center - polygon.Vertices[i]);
+            if (separation > maxSeparation) { maxSeparation = separation; maxEdge = i; }
+        }
+
+        FVector closestPoint;
+        if (maxSeparation > 0.0f)
+        {
+            // 단면 밖: 변들 위에서 가장 가까운 점
+            float closestSq = FLT_MAX;
+            for (int i = 0; i < polygon.NumVertices; i++)
+            {
+                const UCapsule edge(polygon.Vertices[i], polygon.Vertices[(i + 1) % polygon.NumVertices], 0.0f);
+                const FVector point = edge.GetClosestPoint(FVector(center.x, center.y, 0.0f));
+                const float distanceSq = (point.x - center.x) * (point.x - center.x) + (point.y - center.y) * (point.y - center.y);
+                if (distanceSq < closestSq) { closestSq = distanceSq; closestPoint = point; }
+            }
+            closestPoint.z = z;
+        }
+        else if (z != center.z)
+        {
+            // 단면 안이고 기둥 위나 아래
+            closestPoint = FVector(center.x, center.y, z);
+        }
+        else
+        {
+            // 기둥 안: 가장 가까운 옆면이나 앞뒤 면으로 밀어낸다
+            if (!outContact) return true;
+            const float gapZ = polygon.HalfDepth - fabsf(center.z);
+            if (gapZ < -maxSeparation)
+            {
+                const FVector outward(0.0f, 0.0f, center.z >= 0.0f ? 1.0f : -1.0f);
+                outContact->Normal = outward * -1.0f;
+                outContact->Penetration = sphere.Radius + gapZ;
+                outContact->Point = center + outward * gapZ;
+            }
+            else
+            {
+                const FVector& outward = polygon.EdgeNormals[maxEdge];
+                outContact->Normal = outward * -1.0f;
+                outContact->Penetration = sphere.Radius - maxSeparation;
+                outContact->Point = center - outward * maxSeparation;
+            }
+            return true;
+        }
+
+        const FVector toPolygon = closestPoint - center;
+        const float distanceSq = toPolygon.SizeSquared();
+        if (distanceSq >= sphere.Radius * sphere.Radius) return false;
+
+        if (outContact)
+        {
+            const float distance = sqrtf(distanceSq);
+            outContact->Normal = distance > 1e-6f ? toPolygon * (1.0f / distance) : polygon.EdgeNormals[maxEdge] * -1.0f;
+            outContact->Penetration = sphere.Radius - distance;
+            outContact->Point = closestPoint;
+        }
+        return true;
+    }
+};
+
+inline bool UPrimitive::Collision(const UPrimitive* other, FShapeContact* outContact) const
+{
+    return FCollisionDispatcher::Get().Collide(*this, *other, outContact);
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+#include <memory>
+
+// 같은 타입의 도형을 덩어리(slab) 단위로 미리 할당해 두고 나눠 주는 풀
+// 도형 하나마다 new/delete 하는 대신 쓴다. 해제된 칸은 자유 목록으로 바로 재사용하고,
+// 덩어리는 앞의 것의 두 배 크기로 늘리므로 k개를 만들거나 지우는 비용은 O(k)이고 힙이 조각나지 않는다.
+// 덩어리는 옮기지 않으므로 한 번 받은 포인터는 Destroy 할 때까지 그대로 유효하다.
+template <typename T>
+class TPrimitivePool
+{
+public:
+    explicit TPrimitivePool(int firstSlabSize = 64)
+        : NextSlabSize(firstSlabSize > 0 ? firstSlabSize : 1)
+    {
+    }
+
+    TPrimitivePool(const TPrimitivePool&) = delete;
+    TPrimitivePool& operator=(const TPrimitivePool&) = delete;
+
+    ~TPrimitivePool()
+    {
+        Clear();
+    }
+
+    // 빈 칸 하나에 T를 만든다 (빈 칸이 없으면 새 덩어리를 붙인다)
+    template <typename... Args>
+    T* Create(Args&&... args)
+    {
+        if (!FreeList) AddSlab();
+
+        FSlot* slot = FreeList;
+        T* object = new (slot->Storage) T(std::forward<Args>(args)...);
+        FreeList = slot->NextFree;
+        slot->NextFree = nullptr;
+        slot->bAlive = true;
+        NumAlive++;
+        return object;
+    }
+
+    // Create로 받은 객체를 소멸시키고 칸을 자유 목록 앞에 돌려준다
+    void Destroy(T* object)
+    {
+        if (!object) return;
+
+        FSlot* slot = reinterpret_cast<FSlot*>(object);
+        object->~T();
+        slot->bAlive = false;
+        slot->NextFree = FreeList;
+        FreeList = slot;
+        NumAlive--;
+    }
+
+    // 살아 있는 객체를 모두 소멸시킨다 (덩어리는 남겨 두고 다음 Create에 재사용)
+    void Clear()
+    {
+        FreeList = nullptr;
+        for (int s = (int)Slabs.size() - 1; s >= 0; s--)
+        {
+            FSlab& slab = Slabs[s];
+            for (int i = slab.Size - 1; i >= 0; i--)
+            {
+                FSlot& slot = slab.Slots[i];
+                if (slot.bAlive)
+                {
+                    reinterpret_cast<T*>(slot.Storage)->~T();
+                    slot.bAlive = false;
+                }
+                slot.NextFree = FreeList;
+                FreeList = &slot;
+            }
+        }
+        NumAlive = 0;
+    }
+
+    // 살아 있는 객체마다 func(T&)를 부른다 (덩어리 순서, 즉 메모리 순서)
+    template <typename Func>
+    void ForEach(Func func)
+    {
+        for (FSlab& slab : Slabs)
+        {
+            for (int i = 0; i < slab.Size; i++)
+            {
+                if (slab.Slots[i].bAlive)
+                    func(*reinterpret_cast<T*>(slab.Slots[i].Storage));
+            }
+        }
+    }
+
+    int GetNumAlive() const { return NumAlive; }
+
+    int GetCapacity() const
+    {
+        int capacity = 0;
+        for (const FSlab& slab : Slabs) capacity += slab.Size;
+        return capacity;
+    }
+
+private:
+    // Storage가 첫 멤버라서 T*와 FSlot*를 서로 바꿔 쓸 수 있다
+    struct FSlot
+    {
+        alignas(T) unsigned char Storage[sizeof(T)];
+        FSlot* NextFree = nullptr;
+        bool bAlive = false;
+    };
+
+    struct FSlab
+    {
+        std::unique_ptr<FSlot[]> Slots;
+        int Size = 0;
+    };
+
+    // 새 덩어리의 칸을 앞에서부터 꺼내 쓰도록 자유 목록에 잇는다
+    void AddSlab()
+    {
+        FSlab slab;
+        slab.Size = NextSlabSize;
+        slab.Slots.reset(new FSlot[slab.Size]);
+        for (int i = slab.Size - 1; i >= 0; i--)
+        {
+            slab.Slots[i].NextFree = FreeList;
+            FreeList = &slab.Slots[i];
+        }
+        Slabs.push_back(std::move(slab));
+        NextSlabSize *= 2;
+    }
+
+    std::vector<FSlab> Slabs;
+    FSlot* FreeList = nullptr;
+    int NextSlabSize;
+    int NumAlive = 0;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+
+// 빠르고 seed로 재현 가능한 난수 생성기 (PCG32, XSH-RR)
+// rand()와 달리 전역 상태와 잠금이 없고, 같은 seed면 플랫폼과 관계없이 같은 수열이 나온다.
+class FRandom
+{
+public:
+    explicit FRandom(uint64_t seed = 1)
+    {
+        Seed(seed);
+    }
+
+    void Seed(uint64_t seed, uint64_t stream = 0x14057b7ef767814fULL)
+    {
+        State = 0;
+        Increment = (stream << 1) | 1; // 증분은 홀수여야 한다
+        NextUInt();
+        State += seed;
+        NextUInt();
+    }
+
+    uint32_t NextUInt()
+    {
+        const uint64_t oldState = State;
+        State = oldState * 6364136223846793005ULL + Increment;
+        const uint32_t xorShifted = (uint32_t)(((oldState >> 18) ^ oldState) >> 27);
+        const uint32_t rotation = (uint32_t)(oldState >> 59);
+        return (xorShifted >> rotation) | (xorShifted << ((32 - rotation) & 31));
+    }
+
+    // [0, 1) 범위의 실수 (상위 24비트를 써서 1.0이 나오지 않게)
+    float NextFloat()
+    {
+        return (NextUInt() >> 8) * (1.0f / 16777216.0f);
+    }
+
+    // [min, max) 범위의 실수
+    float NextRange(float min, float max)
+    {
+        return min + (max - min) * NextFloat();
+    }
+
+    // [0, n) 범위의 정수 (곱셈으로 줄이므로 나머지 연산보다 빠르고 치우침도 작다)
+    int NextInt(int n)
+    {
+        return (int)(((uint64_t)NextUInt() * (uint32_t)n) >> 32);
+    }
+
+private:
+    uint64_t State = 0;
+    uint64_t Increment = 1;
+};
@@ -0,0 +1,337 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <limits>
+
+#include "Vector.h"
+
+// 공이 들어 있는 용기의 모양을 격자에 구워 둔 부호 거리장 (2D 또는 3D)
+// 격자점마다 용기 벽까지의 거리를 저장하고, 빈 공간(안쪽)은 양수, 막힌 곳(바깥쪽)은 음수다.
+// 공 하나의 벽 검사는 중심이 든 칸의 꼭짓점 4개(3D는 8개)를 보간한 값과, 같은 값들로 구한 기울기 하나로 끝나므로
+// 원, 오목한 다각형, 그림에서 읽은 모양처럼 복잡한 용기도 사각형 벽과 같은 비용이 든다.
+// SizeZ가 1이면 2D 격자로 보고 z를 무시한다 (xy 모양을 z 방향으로 늘인 기둥).
+class FSignedDistanceField
+{
+public:
+    int SizeX = 0;
+    int SizeY = 0;
+    int SizeZ = 0;
+    float CellSize = 1.0f;
+    FVector Origin; // 격자점 (0, 0, 0)의 위치
+
+    bool IsEmpty() const { return Distances.empty(); }
+
+    void Clear()
+    {
+        Distances.clear();
+        SizeX = SizeY = SizeZ = 0;
+    }
+
+    // [-extent, extent] 정육면체(sizeZ가 1이면 정사각형)를 축마다 size개 점으로 나누고 점마다 distance(위치)를 저장한다
+    template <typename Func>
+    void Bake(int size, int sizeZ, float extent, const Func& distance)
+    {
+        SetGrid(size, sizeZ, extent);
+        for (int z = 0; z < SizeZ; z++)
+        for (int y = 0; y < SizeY; y++)
+        for (int x = 0; x < SizeX; x++)
+            Distances[GetIndex(x, y, z)] = distance(GetPoint(x, y, z));
+    }
+
+    // 흑백 그림을 2D 거리장으로 굽는다 (0이 아닌 픽셀이 빈 공간, 첫 행이 위쪽)
+    // 빈 칸과 막힌 칸 각각에서 반대쪽까지의 거리를 정확한 유클리드 거리 변환으로 구해 부호를 붙인다.
+    // 긴 변이 [-extent, extent]에 맞도록 픽셀 하나를 격자 한 칸으로 쓴다
+    // 보간에 칸이 하나는 있어야 하므로 가로나 세로가 2픽셀보다 작으면 false를 반환하고 거리장을 바꾸지 않는다
+    bool BakeMask(const uint8_t* mask, int width, int height, float extent)
+    {
+        if (width < 2 || height < 2) return false;
+
+        SizeX = width;
+        SizeY = height;
+        SizeZ = 1;
+        CellSize = 2.0f * extent / (float)std::max(std::max(width, height) - 1, 1);
+        Origin = FVector(-0.5f * CellSize * (width - 1), -0.5f * CellSize * (height - 1), 0.0f);
+        Distances.assign((size_t)width * height, 0.0f);
+
+        std::vector<float> toSolid;
+        std::vector<float> toFree;
+        DistanceTransform(mask, width, height, false, toSolid);
+        DistanceTransform(mask, width, height, true, toFree);
+
+        // 경계는 두 픽셀 사이에 있다고 보고 반 칸씩 뺀다
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                const size_t pixel = (size_t)y * width + x;
+                const float distance = mask[pixel] ? sqrtf(toSolid[pixel]) - 0.5f : 0.5f - sqrtf(toFree[pixel]);
+                Distances[GetIndex(x, height - 1 - y, 0)] = distance * CellSize;
+            }
+        }
+        return true;
+    }
+
+    // 이진 PGM(P5) 그림을 읽어 밝은 픽셀은 1, 어두운 픽셀은 0으로 돌려준다 (그림 라이브러리 없이 용기 모양을 파일로 받기 위해)
+    // BakeMask가 받지 못하는 2픽셀보다 작은 그림은 false
+    static bool LoadPgm(const char* path, std::vector<uint8_t>& outPixels, int& outWidth, int& outHeight)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::string magic;
+        int maxValue = 0;
+        if (!(file >> magic) || !ReadPgmValue(file, outWidth) || !ReadPgmValue(file, outHeight) || !ReadPgmValue(file, maxValue)) return false;
+        if (magic != "P5" || outWidth < 2 || outHeight < 2 || maxValue <= 0 || maxValue > 255) return false;
+
+        file.get(); // 헤더 끝의 공백 한 글자
+        outPixels.resize((size_t)outWidth * outHeight);
+        if (!file.read(reinterpret_cast<char*>(outPixels.data()), outPixels.size())) return false;
+
+        for (uint8_t& pixel : outPixels)
+            pixel = pixel * 2 > maxValue ? 1 : 0;
+        return true;
+    }
+
+    // 보간한 거리 (격자 밖은 가장 가까운 가장자리 칸으로)
+    float Sample(const FVector& point) const
+    {
+        float distance;
+        FVector gradient;
+        SampleWithGradient(point, distance, gradient);
+        return distance;
+    }
+
+    // 보간한 거리와 그 기울기 (기울기는 빈 공간 쪽을 향하고, 같은 꼭짓점 값들을 미분해 구하므로 추가로 읽지 않는다)
+    void SampleWithGradient(const FVector& point, float& outDistance, FVector& outGradient) const
+    {
+        const float invCell = 1.0f / CellSize;
+        int ix, iy, iz;
+        float fx, fy, fz;
+        GetCell((point.x - Origin.x) * invCell, SizeX, ix, fx);
+        GetCell((point.y - Origin.y) * invCell, SizeY, iy, fy);
+
+        const float d000 = Distances[GetIndex(ix, iy, 0)];
+        if (SizeZ == 1)
+        {
+            const float d100 = Distances[GetIndex(ix + 1, iy, 0)];
+            const float d010 = Distances[GetIndex(ix, iy + 1, 0)];
+            const float d110 = Distances[GetIndex(ix + 1, iy + 1, 0)];
+            const float bottom = d000 + (d100 - d000) * fx;
+            const float top = d010 + (d110 - d010) * fx;
+            outDistance = bottom + (top - bottom) * fy;
+            outGradient = FVector(
+                ((d100 - d000) + ((d110 - d010) - (d100 - d000)) * fy) * invCell,
+                (top - bottom) * invCell,
+                0.0f);
+            return;
+        }
+
+        GetCell((point.z - Origin.z) * invCell, SizeZ, iz, fz);
+        float d[8];
+        for (int corner = 0; corner < 8; corner++)
+            d[corner] = Distances[GetIndex(ix + (corner & 1), iy + ((corner >> 1) & 1), iz + (corner >> 2))];
+
+        // x로 먼저 보간한 네 모서리 값과 그 x 미분
+        float edge[4];
+        float edgeDx[4];
+        for (int k = 0; k < 4; k++)
+        {
+            edge[k] = d[2 * k] + (d[2 * k + 1] - d[2 * k]) * fx;
+            edgeDx[k] = d[2 * k + 1] - d[2 * k];
+        }
+        const float front = edge[0] + (edge[1] - edge[0]) * fy;
+        const float back = edge[2] + (edge[3] - edge[2]) * fy;
+        const float frontDx = edgeDx[0] + (edgeDx[1] - edgeDx[0]) * fy;
+        const float backDx = edgeDx[2] + (edgeDx[3] - edgeDx[2]) * fy;
+        const float frontDy = edge[1] - edge[0];
+        const float backDy = edge[3] - edge[2];
+
+        outDistance = front + (back - front) * fz;
+        outGradient = FVector(
+            (frontDx + (backDx - frontDx) * fz) * invCell,
+            (frontDy + (backDy - frontDy) * fz) * invCell,
+            (back - front) * invCell);
+    }
+
+    // z = 0 단면에서 거리 0인 등고선을 선분으로 덧붙인다 (marching squares)
+    void GetOutline(std::vector<FVector>& outLines) const
+    {
+        if (IsEmpty()) return;
+
+        const int z = SizeZ == 1 ? 0 : std::min(std::max((int)floorf(-Origin.z / CellSize + 0.5f), 0), SizeZ - 1);
+        for (int y = 0; y + 1 < SizeY; y++)
+        {
+            for (int x = 0; x + 1 < SizeX; x++)
+            {
+                // 칸의 네 변 (아래, 오른쪽, 위, 왼쪽)에서 부호가 바뀌는 점을 모은다
+                const int cx[4] = { x, x + 1, x + 1, x };
+                const int cy[4] = { y, y, y + 1, y + 1 };
+                FVector crossings[4];
+                int numCrossings = 0;
+                for (int edge = 0; edge < 4; edge++)
+                {
+                    const int next = (edge + 1) & 3;
+                    const float da = Distances[GetIndex(cx[edge], cy[edge], z)];
+                    const float db = Distances[GetIndex(cx[next], cy[next], z)];
+                    if ((da < 0.0f) == (db < 0.0f)) continue;
+
+                    const float t = da / (da - db);
+                    const FVector a = GetPoint(cx[edge], cy[edge], z);
+                    const FVector b = GetPoint(cx[next], cy[next], z);
+                    crossings[numCrossings++] = FVector(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, 0.0f);
+                }
+                // 안장점 칸(교차 4개)은 변 순서대로 둘씩 잇는다
+                for (int k = 0; k + 1 < numCrossings; k += 2)
+                {
+                    outLines.push_back(crossings[k]);
+                    outLines.push_back(crossings[k + 1]);
+                }
+            }
+        }
+    }
+
+    // 원(3D에서는 구) 용기: 안쪽이 양수
+    static float DistanceToSphere(const FVector& point, const FVector& center, float radius)
+    {
+        return radius - (point - center).Size();
+    }
+
+    // xy 평면의 단순 다각형 용기 (오목해도 되고 감는 방향은 상관없다): 안쪽이 양수
+    static float DistanceToPolygon(const FVector& point, const FVector* vertices, int numVertices)
+    {
+        float closestSq = FLT_MAX;
+        bool bInside = false;
+        for (int i = 0, j = numVertices - 1; i < numVertices; j = i++)
+        {
+            const FVector& a = vertices[j];
+            const FVector& b = vertices[i];
+            const float ex = b.x - a.x;
+            const float ey = b.y - a.y;
+            const float px = point.x - a.x;
+            const float py = point.y - a.y;
+            const float lengthSq = ex * ex + ey * ey;
+            const float t = lengthSq > 1e-12f ? std::min(std::max((px * ex + py * ey) / lengthSq, 0.0f), 1.0f) : 0.0f;
+            const float dx = px - ex * t;
+            const float dy = py - ey * t;
+            closestSq = std::min(closestSq, dx * dx + dy * dy);
+
+            // 오른쪽으로 쏜 반직선이 변을 몇 번 지나는지 (홀수면 안쪽)
+            if ((a.y > point.y) != (b.y > point.y) && point.x < a.x + ex * (point.y - a.y) / ey)
+                bInside = !bInside;
+        }
+        const float distance = sqrtf(closestSq);
+        return bInside ? distance : -distance;
+    }
+
+private:
+    std::vector<float> Distances; // x가 가장 빠르게 바뀌는 순서
+
+    int GetIndex(int x, int y, int z) const
+    {
+        return (z * SizeY + y) * SizeX + x;
+    }
+
+    FVector GetPoint(int x, int y, int z) const
+    {
+        return FVector(Origin.x + x * CellSize, Origin.y + y * CellSize, SizeZ == 1 ? 0.0f : Origin.z + z * CellSize);
+    }
+
+    void SetGrid(int size, int sizeZ, float extent)
+    {
+        SizeX = std::max(size, 2);
+        SizeY = SizeX;
+        SizeZ = sizeZ > 1 ? sizeZ : 1;
+        CellSize = 2.0f * extent / (float)(SizeX - 1);
+        Origin = FVector(-extent, -extent, SizeZ == 1 ? 0.0f : -extent);
+        Distances.assign((size_t)SizeX * SizeY * SizeZ, 0.0f);
+    }
+
+    // PGM 헤더의 다음 숫자 (앞의 공백과 '#'부터 줄 끝까지인 주석은 건너뛴다)
+    static bool ReadPgmValue(std::istream& file, int& outValue)
+    {
+        file >> std::ws;
+        while (file.peek() == '#')
+        {
+            file.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            file >> std::ws;
+        }
+        return static_cast<bool>(file >> outValue);
+    }
+
+    // 격자 좌표를 칸 번호와 칸 안의 위치 [0, 1]로 나눈다 (격자 밖은 가장자리 칸에 붙인다)
+    static void GetCell(float coord, int size, int& outCell, float& outFraction)
+    {
+        const float clamped = std::min(std::max(coord, 0.0f), (float)(size - 1));
+        outCell = std::min((int)clamped, size - 2);
+        outFraction = clamped - (float)outCell;
+    }
+
+    // 픽셀마다 mask 값이 target인 가장 가까운 픽셀까지의 거리 제곱 (Felzenszwalb-Huttenlocher, 행과 열로 나눠 O(n))
+    static void DistanceTransform(const uint8_t* mask, int width, int height, bool target, std::vector<float>& outDistanceSq)
+    {
+        const float infinity = 1e20f;
+        outDistanceSq.resize((size_t)width * height);
+        for (size_t pixel = 0; pixel < outDistanceSq.size(); pixel++)
+            outDistanceSq[pixel] = (mask[pixel] != 0) == target ? 0.0f : infinity;
+
+        const int maxSize = std::max(width, height);
+        std::vector<float> line(maxSize);
+        std::vector<float> result(maxSize);
+        std::vector<int> parabolas(maxSize);
+        std::vector<float> bounds(maxSize + 1);
+
+        for (int x = 0; x < width; x++)
+        {
+            for (int y = 0; y < height; y++) line[y] = outDistanceSq[(size_t)y * width + x];
+            DistanceTransform1D(line.data(), height, result.data(), parabolas.data(), bounds.data());
+            for (int y = 0; y < height; y++) outDistanceSq[(size_t)y * width + x] = result[y];
+        }
+        for (int y = 0; y < height; y++)
+        {
+            float* row = &outDistanceSq[(size_t)y * width];
+            std::copy(row, row + width, line.begin());
+            DistanceTransform1D(line.data(), width, row, parabolas.data(), bounds.data());
+        }
+    }
+
+    // 포물선 q와 p가 만나는 위치
+    static float Intersect(const float* f, int q, int p)
+    {
+        return ((f[q] + (float)q * q) - (f[p] + (float)p * p)) / (2.0f * (q - p));
+    }
+
+    // 1차원 거리 변환: 각 점에서 min_q (f[q] + (p - q)^2) 을 포물선들의 아래 껍질로 구한다
+    static void DistanceTransform1D(const float* f, int n, float* out, int* parabolas, float* bounds)
+    {
+        // parabolas[0..k]는 아래 껍질을 이루는 포물선, bounds[k]~bounds[k + 1]은 포물선 k가 가장 낮은 구간
+        int k = 0;
+        parabolas[0] = 0;
+        bounds[0] = -FLT_MAX;
+        bounds[1] = FLT_MAX;
+        for (int q = 1; q < n; q++)
+        {
+            float s = Intersect(f, q, parabolas[k]);
+            while (s <= bounds[k])
+            {
+                k--;
+                s = Intersect(f, q, parabolas[k]);
+            }
+            k++;
+            parabolas[k] = q;
+            bounds[k] = s;
+            bounds[k + 1] = FLT_MAX;
+        }
+
+        k = 0;
+        for (int q = 0; q < n; q++)
+        {
+            while (bounds[k + 1] < (float)q) k++;
+            const int p = parabolas[k];
+            out[q] = (float)(q - p) * (q - p) + f[p];
+        }
+    }
+};
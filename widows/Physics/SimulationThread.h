@@ -0,0 +1,397 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include "Vector.h"
+#include "JobSystem.h"
+#include "BallSimulation.h"
+#include "FixedTimestep.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
+
+// UI에서 바꾸는 시뮬레이션 설정 (UI 스레드가 자기 사본을 고치고 FSimulationThread::UpdateSettings로 넘긴다)
+struct FSimulationSettings
+{
+    int BallCount = 0;
+    bool EnableGravity = false;
+    bool Enable3D = false;
+    int ObstacleLayout = ObstacleLayout_None;
+    int ContainerShape = Container_Box;
+    int BroadPhaseType = BroadPhase_SpatialHash;
+    int SolverType = Solver_Impulse;
+    bool EnableCcd = true;
+    bool EnableSleeping = true;
+    int CollisionPasses = 2;
+    bool EnableAdaptiveSubsteps = true; // 속도에 맞춰 서브스텝 수를 고른다 (켜면 CollisionPasses 대신 서브스텝마다 한 번)
+    int ReorderInterval = 60;
+    int ThreadCap = 0;               // 잡 시스템 스레드 수 (0이면 모든 코어)
+    bool DeterministicJobs = false;
+};
+
+// 화면 표시용 통계 (스냅숏을 낼 때의 값)
+struct FSimulationStats
+{
+    int NumAwake = 0;
+    int NumPairs = 0;
+    int NumContacts = 0;
+    int NumBatches = 0;
+    int SolverIterations = 0;
+    int NumConstraints = 0;     // XPBD: 마지막 서브스텝의 위치 제약 수
+    float MaxError = 0.0f;      // XPBD: 반복 뒤 남은 가장 큰 겹침
+    int NumWarmStarted = 0;
+    int NumFastBalls = 0;
+    int NumImpacts = 0;
+    int SpawnOverlaps = 0;
+    int TreeHeight = 0;
+    int NumReinserted = 0;
+    int SapSwaps = 0;
+    int SapAdded = 0;
+    int SapRemoved = 0;
+    int NumObstacles = 0;
+    int NumBvhNodes = 0;
+    int NumObstacleCandidates = 0;
+    int NumObstacleContacts = 0;
+    int NumThreads = 1;
+    int LastSteps = 0;          // 마지막으로 스냅숏을 내기 전에 몰아서 진행한 스텝 수
+    int LastSubsteps = 1;       // 마지막 스텝을 나눈 서브스텝 수
+    float StepTime = 0.0f;      // 물리 한 스텝의 길이 (초)
+    float StepMs = 0.0f;        // 물리 한 스텝을 계산하는 데 걸린 실제 시간
+    int NumDroppedCommands = 0; // 큐가 가득 차서 버린 명령 수
+};
+
+// 물리 스레드가 내보내는 한 시점의 공 상태 (렌더러는 다음 스냅숏이 올 때까지 이것만 읽는다)
+struct FBallSnapshot
+{
+    int Count = 0;
+    std::vector<float> PosX, PosY, PosZ;
+    std::vector<float> PrevPosX, PrevPosY, PrevPosZ; // 마지막 스텝 직전 위치 (보간용)
+    std::vector<float> Radius;
+    std::vector<uint32_t> Ids;
+
+    double PublishTime = 0.0; // 낸 시각 (steady_clock, 초)
+    bool Enable3D = false;
+    FSimulationStats Stats;
+
+    int ObstacleVersion = -1;            // 장애물이나 용기가 바뀔 때마다 늘어난다
+    std::vector<FVector> ObstacleOutline; // 장애물과 용기 외곽선 (선분 양 끝점이 두 개씩)
+
+    FVector GetInterpolatedLocation(int i, float alpha) const
+    {
+        return FVector(
+            PrevPosX[i] + (PosX[i] - PrevPosX[i]) * alpha,
+            PrevPosY[i] + (PosY[i] - PrevPosY[i]) * alpha,
+            PrevPosZ[i] + (PosZ[i] - PrevPosZ[i]) * alpha);
+    }
+
+    // now 시각에 그릴 보간 비율: 마지막 스텝 직전 상태에서 한 스텝 동안 움직인다 (한 스텝 늦게 그려서 튀지 않는다)
+    float GetAlpha(double now) const
+    {
+        if (Stats.StepTime <= 0.0f) return 1.0f;
+        return std::min(std::max((float)((now - PublishTime) / Stats.StepTime), 0.0f), 1.0f);
+    }
+};
+
+// 물리를 자기 스레드에서 돌리는 실행기
+// UI 스레드는 설정 변경과 폭발을 잠금 없는 명령 큐로 보내고, 물리 스레드가 스텝 사이에 꺼내 적용한다.
+// 물리 스레드는 스텝마다 공 상태를 삼중 버퍼의 스냅숏으로 내보내고, 렌더러는 가장 최근 스냅숏을 가져가 그린다.
+// 두 스레드는 서로를 기다리지 않으므로 느린 물리 스텝이 입력을 막지 않고, VSync가 물리를 막지 않는다.
+// 시작한 뒤에는 FBallSimulation과 잡 시스템을 물리 스레드만 만진다.
+class FSimulationThread
+{
+public:
+    FSimulationThread(FBallSimulation& simulation, FJobSystem& jobs)
+        : Simulation(simulation), Jobs(jobs)
+    {
+    }
+
+    FSimulationThread(const FSimulationThread&) = delete;
+    FSimulationThread& operator=(const FSimulationThread&) = delete;
+
+    ~FSimulationThread()
+    {
+        Stop();
+    }
+
+    // 고정 간격 물리 시계 (Start 전에만 고친다)
+    FFixedTimestep Clock;
+
+    // settings를 적용하고 물리 스레드를 시작한다 (잡 시스템도 물리 스레드에서 시작한다)
+    void Start(const FSimulationSettings& settings)
+    {
+        Stop();
+        SentSettings = settings;
+        ApplySettings(settings);
+        bRunning = true;
+        Thread = std::thread([this]() { ThreadMain(); });
+    }
+
+    void Stop()
+    {
+        if (!Thread.joinable()) return;
+        bRunning = false;
+        Thread.join();
+    }
+
+    // UI 스레드: 지난번에 보낸 설정과 달라진 값만 명령으로 보낸다 (큐가 가득 차면 다음 호출에서 다시 보낸다)
+    void UpdateSettings(const FSimulationSettings& settings)
+    {
+        SendIfChanged(SentSettings.BallCount, settings.BallCount, Command_SetBallCount);
+        SendIfChanged(SentSettings.EnableGravity, settings.EnableGravity, Command_SetGravity);
+        SendIfChanged(SentSettings.Enable3D, settings.Enable3D, Command_SetEnable3D);
+        SendIfChanged(SentSettings.ObstacleLayout, settings.ObstacleLayout, Command_SetObstacleLayout);
+        SendIfChanged(SentSettings.ContainerShape, settings.ContainerShape, Command_SetContainerShape);
+        SendIfChanged(SentSettings.BroadPhaseType, settings.BroadPhaseType, Command_SetBroadPhase);
+        SendIfChanged(SentSettings.SolverType, settings.SolverType, Command_SetSolver);
+        SendIfChanged(SentSettings.EnableCcd, settings.EnableCcd, Command_SetCcd);
+        SendIfChanged(SentSettings.EnableSleeping, settings.EnableSleeping, Command_SetSleeping);
+        SendIfChanged(SentSettings.CollisionPasses, settings.CollisionPasses, Command_SetCollisionPasses);
+        SendIfChanged(SentSettings.EnableAdaptiveSubsteps, settings.EnableAdaptiveSubsteps, Command_SetAdaptiveSubsteps);
+        SendIfChanged(SentSettings.ReorderInterval, settings.ReorderInterval, Command_SetReorderInterval);
+        SendIfChanged(SentSettings.ThreadCap, settings.ThreadCap, Command_SetThreadCap);
+        SendIfChanged(SentSettings.DeterministicJobs, settings.DeterministicJobs, Command_SetDeterministic);
+    }
+
+    // UI 스레드: center에서 폭발을 일으킨다 (다음 스텝 전에 적용)
+    void Explode(const FVector& center, float radius, float speed)
+    {
+        FCommand command;
+        command.Type = Command_Explode;
+        command.Point = center;
+        command.Radius = radius;
+        command.Speed = speed;
+        if (!Commands.Push(command))
+            NumDroppedCommands.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // UI 스레드: 새 스냅숏이 나왔으면 가져온다
+    bool AcquireSnapshot()
+    {
+        return Snapshots.Acquire();
+    }
+
+    // UI 스레드: 마지막으로 가져온 스냅숏
+    const FBallSnapshot& GetSnapshot() const
+    {
+        return Snapshots.GetReadBuffer();
+    }
+
+    static double Now()
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    enum ECommandType
+    {
+        Command_SetBallCount,
+        Command_SetGravity,
+        Command_SetEnable3D,
+        Command_SetObstacleLayout,
+        Command_SetContainerShape,
+        Command_SetBroadPhase,
+        Command_SetSolver,
+        Command_SetCcd,
+        Command_SetSleeping,
+        Command_SetCollisionPasses,
+        Command_SetAdaptiveSubsteps,
+        Command_SetReorderInterval,
+        Command_SetThreadCap,
+        Command_SetDeterministic,
+        Command_Explode,
+    };
+
+    struct FCommand
+    {
+        int Type = Command_SetBallCount;
+        int Value = 0;
+        FVector Point;
+        float Radius = 0.0f;
+        float Speed = 0.0f;
+    };
+
+    template <typename T>
+    void SendIfChanged(T& sent, T value, int type)
+    {
+        if (sent == value) return;
+
+        FCommand command;
+        command.Type = type;
+        command.Value = (int)value;
+        if (Commands.Push(command))
+            sent = value;
+    }
+
+    // 물리 스레드가 시작하기 전에 처음 설정을 그대로 넣는다
+    void ApplySettings(const FSimulationSettings& settings)
+    {
+        Simulation.EnableGravity = settings.EnableGravity;
+        Simulation.SetEnable3D(settings.Enable3D);
+        Simulation.SetObstacleLayout(settings.ObstacleLayout);
+        Simulation.SetContainerShape(settings.ContainerShape);
+        Simulation.BroadPhaseType = settings.BroadPhaseType;
+        Simulation.SolverType = settings.SolverType;
+        Simulation.EnableCcd = settings.EnableCcd;
+        Simulation.World.EnableSleeping = settings.EnableSleeping;
+        Simulation.CollisionPasses = settings.CollisionPasses;
+        Simulation.EnableAdaptiveSubsteps = settings.EnableAdaptiveSubsteps;
+        Simulation.ReorderInterval = settings.ReorderInterval;
+        DesiredBallCount = std::max(settings.BallCount, 0);
+        ThreadCap = settings.ThreadCap;
+        Jobs.Deterministic = settings.DeterministicJobs;
+        ObstacleVersion++;
+    }
+
+    void Execute(const FCommand& command)
+    {
+        switch (command.Type)
+        {
+        case Command_SetBallCount: DesiredBallCount = std::max(command.Value, 0); break;
+        case Command_SetGravity:
+            Simulation.EnableGravity = command.Value != 0;
+            Simulation.World.WakeAll(); // 중력이 바뀌면 잠든 공도 다시 움직여야 한다
+            break;
+        case Command_SetEnable3D: Simulation.SetEnable3D(command.Value != 0); ObstacleVersion++; break;
+        case Command_SetObstacleLayout: Simulation.SetObstacleLayout(command.Value); ObstacleVersion++; break;
+        case Command_SetContainerShape: Simulation.SetContainerShape(command.Value); ObstacleVersion++; break;
+        case Command_SetBroadPhase: Simulation.BroadPhaseType = command.Value; break;
+        case Command_SetSolver: Simulation.SolverType = command.Value; break;
+        case Command_SetCcd: Simulation.EnableCcd = command.Value != 0; break;
+        case Command_SetSleeping: Simulation.World.EnableSleeping = command.Value != 0; break;
+        case Command_SetCollisionPasses: Simulation.CollisionPasses = command.Value; break;
+        case Command_SetAdaptiveSubsteps: Simulation.EnableAdaptiveSubsteps = command.Value != 0; break;
+        case Command_SetReorderInterval: Simulation.ReorderInterval = command.Value; break;
+        case Command_SetThreadCap: ThreadCap = command.Value; Jobs.Start(ThreadCap); break;
+        case Command_SetDeterministic: Jobs.Deterministic = command.Value != 0; break;
+        case Command_Explode: Simulation.ApplyExplosion(command.Point, command.Radius, command.Speed); break;
+        default: break;
+        }
+    }
+
+    void ThreadMain()
+    {
+        Jobs.Start(ThreadCap);
+        Publish(0);
+
+        double last = Now();
+        while (bRunning)
+        {
+            bool bChanged = false;
+            FCommand command;
+            while (Commands.Pop(command))
+            {
+                Execute(command);
+                bChanged = true;
+            }
+
+            // 모드를 바꾸면 공이 지워지므로 원하는 공 수는 매번 다시 맞춘다
+            if (Simulation.World.Count != DesiredBallCount)
+            {
+                Simulation.SetBallCount(DesiredBallCount);
+                bChanged = true;
+            }
+
+            const double now = Now();
+            const int steps = Clock.Advance(now - last);
+            last = now;
+            for (int step = 0; step < steps; step++)
+            {
+                const double stepBegin = Now();
+                Simulation.Step(Clock.StepTime);
+                StepMs = (float)((Now() - stepBegin) * 1e3);
+            }
+
+            if (steps > 0 || bChanged)
+            {
+                Publish(steps);
+                continue;
+            }
+
+            // 다음 스텝 시각까지 쉰다 (명령은 그 뒤에 한꺼번에 처리)
+            const double wait = Clock.StepTime - Clock.Accumulator;
+            if (wait > 0.0)
+                std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+        }
+
+        Jobs.Shutdown();
+    }
+
+    // 현재 상태를 쓰기 버퍼에 복사해 내보낸다
+    void Publish(int steps)
+    {
+        FBallSnapshot& snapshot = Snapshots.GetWriteBuffer();
+        const FBallWorld& world = Simulation.World;
+        const int count = world.Count;
+        snapshot.Count = count;
+        snapshot.PosX.assign(world.PosX, world.PosX + count);
+        snapshot.PosY.assign(world.PosY, world.PosY + count);
+        snapshot.PosZ.assign(world.PosZ, world.PosZ + count);
+        snapshot.PrevPosX.assign(world.PrevPosX, world.PrevPosX + count);
+        snapshot.PrevPosY.assign(world.PrevPosY, world.PrevPosY + count);
+        snapshot.PrevPosZ.assign(world.PrevPosZ, world.PrevPosZ + count);
+        snapshot.Radius.assign(world.Radius, world.Radius + count);
+        snapshot.Ids.assign(world.Ids.begin(), world.Ids.begin() + count);
+        snapshot.PublishTime = Now();
+        snapshot.Enable3D = Simulation.Enable3D;
+
+        // 외곽선은 이 버퍼가 들고 있는 것이 낡았을 때만 다시 만든다
+        if (snapshot.ObstacleVersion != ObstacleVersion)
+        {
+            snapshot.ObstacleOutline.clear();
+            Simulation.Obstacles.GetOutline(snapshot.ObstacleOutline);
+            snapshot.ObstacleVersion = ObstacleVersion;
+        }
+
+        FSimulationStats& stats = snapshot.Stats;
+        stats.NumAwake = (int)Simulation.World.GetAwakeBalls().size();
+        stats.NumPairs = (int)Simulation.CollisionPairs.size();
+        stats.NumContacts = Simulation.NumContacts;
+        stats.NumBatches = Simulation.ContactSolver.NumBatches;
+        stats.SolverIterations = Simulation.ContactSolver.NumIterations;
+        stats.NumConstraints = Simulation.PositionSolver.NumConstraints;
+        stats.MaxError = Simulation.PositionSolver.MaxError;
+        stats.NumWarmStarted = Simulation.ContactSolver.NumWarmStarted;
+        stats.NumFastBalls = Simulation.ContinuousCollision.NumFastBalls;
+        stats.NumImpacts = Simulation.ContinuousCollision.NumImpacts;
+        stats.SpawnOverlaps = Simulation.Spawner.NumOverlapped;
+        stats.TreeHeight = Simulation.BallTree.GetHeight();
+        stats.NumReinserted = Simulation.BallTree.NumReinserted;
+        stats.SapSwaps = Simulation.SweepAndPrune.NumSwaps;
+        stats.SapAdded = (int)Simulation.SweepAndPrune.AddedPairs.size();
+        stats.SapRemoved = (int)Simulation.SweepAndPrune.RemovedPairs.size();
+        stats.NumObstacles = Simulation.Obstacles.GetNumObstacles();
+        stats.NumBvhNodes = Simulation.Obstacles.GetNumBvhNodes();
+        stats.NumObstacleCandidates = Simulation.Obstacles.NumCandidates;
+        stats.NumObstacleContacts = (int)Simulation.ObstacleContacts.size();
+        stats.NumThreads = Jobs.GetNumThreads();
+        stats.LastSteps = steps;
+        stats.LastSubsteps = Simulation.LastSubsteps;
+        stats.StepTime = Clock.StepTime;
+        stats.StepMs = StepMs;
+        stats.NumDroppedCommands = NumDroppedCommands.load(std::memory_order_relaxed);
+
+        Snapshots.Publish();
+    }
+
+    FBallSimulation& Simulation;
+    FJobSystem& Jobs;
+    std::thread Thread;
+    std::atomic<bool> bRunning{ false };
+
+    TSpscQueue<FCommand, 256> Commands;
+    TTripleBuffer<FBallSnapshot> Snapshots;
+    std::atomic<int> NumDroppedCommands{ 0 };
+
+    // UI 스레드 쪽 상태
+    FSimulationSettings SentSettings; // 마지막으로 명령을 보낸 설정
+
+    // 물리 스레드 쪽 상태
+    int DesiredBallCount = 0;
+    int ThreadCap = 0;
+    int ObstacleVersion = 0;
+    float StepMs = 0.0f;
+};
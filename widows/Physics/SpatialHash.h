@@ -0,0 +1,248 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "Contact.h"
+#include "JobSystem.h"
+
+// 균일 격자 + 해시 테이블 기반 브로드페이즈
+// 공을 AABB가 걸치는 모든 셀에 넣고, 같은 셀을 공유하면서 AABB가 겹치는 공끼리만 후보 쌍을 만든다.
+// 쌍은 질의 공 순서대로, 한 공 안에서는 셀과 버킷 순서대로 나온다. 스레드 수와 무관하게 매 프레임 같은 순서다.
+// 모든 공의 z가 같으면 (2D 모드) z 방향으로는 셀 하나만 쓴다.
+class FSpatialHash
+{
+public:
+    // 마지막 FindPairs 때 반지름 분포로부터 계산된 셀 크기
+    float CellSize = 0.1f;
+
+    // 현재 위치로 격자를 만들고 AABB가 겹치는 쌍을 outPairs에 채운다
+    void FindPairs(const float* x, const float* y, const float* z, const float* radius, int count, FJobSystem& jobs, std::vector<FCollisionPair>& outPairs)
+    {
+        X = x; Y = y; Z = z; Radius = radius; Count = count;
+        outPairs.clear();
+        if (Count < 2) return;
+
+        Build(jobs, nullptr, Count);
+        CollectPairs(jobs, Count, outPairs,
+            [](int q) { return q; },
+            [](int i, int j) { return j > i; });
+    }
+
+    // queries에 있는 공과 AABB가 겹치는 쌍만 찾는다 (isQuery[i]는 i가 queries에 있는지)
+    // 쌍은 A < B로 한 번씩만 나오며, 일부 공만 다시 검사할 때 전체 쌍을 만들지 않아도 된다
+    void FindPairsFor(const float* x, const float* y, const float* z, const float* radius, int count,
+        const int* queries, int numQueries, const uint8_t* isQuery, FJobSystem& jobs, std::vector<FCollisionPair>& outPairs)
+    {
+        X = x; Y = y; Z = z; Radius = radius; Count = count;
+        outPairs.clear();
+        if (Count < 2 || numQueries == 0) return;
+
+        Build(jobs, nullptr, Count);
+        CollectPairs(jobs, numQueries, outPairs,
+            [queries](int q) { return queries[q]; },
+            [isQuery](int i, int j) { return !isQuery[j] || j > i; }); // 둘 다 질의 공이면 작은 쪽에서만
+    }
+
+    // FindPairsFor와 같은 쌍을 찾되, 격자에는 members만 넣고 모든 공으로 질의한다 (isMember[i]는 i가 members에 있는지)
+    // members가 적으면 격자가 작아 캐시에 머물고, 질의는 대부분 빈 버킷에서 끝난다
+    void FindPairsAgainst(const float* x, const float* y, const float* z, const float* radius, int count,
+        const int* members, int numMembers, const uint8_t* isMember, FJobSystem& jobs, std::vector<FCollisionPair>& outPairs)
+    {
+        X = x; Y = y; Z = z; Radius = radius; Count = count;
+        outPairs.clear();
+        if (Count < 2 || numMembers == 0) return;
+
+        Build(jobs, members, numMembers);
+        CollectPairs(jobs, Count, outPairs,
+            [](int q) { return q; },
+            [isMember](int i, int j) { return !isMember[i] || j > i; }); // 둘 다 members면 작은 쪽에서만
+    }
+
+private:
+    struct FCell
+    {
+        int x, y, z;
+    };
+
+    static const int BuildGrain = 4096; // 셀 범위 계산 잡 하나가 맡는 공 수
+    static const int QueryGrain = 1024; // 쌍 찾기 잡 하나가 맡는 공 수
+
+    // 현재 위치로 격자를 만든다. 셀 범위는 모든 공에 대해 구하고, 격자에는 members만 넣는다 (nullptr이면 모든 공)
+    void Build(FJobSystem& jobs, const int* members, int numMembers)
+    {
+        Members = members;
+        NumMembers = numMembers;
+        ComputeCellSize();
+        const float invCellSize = 1.0f / CellSize;
+
+        // 1. 공마다 걸치는 셀 범위 계산 (병렬)
+        CellMin.resize(Count);
+        CellMax.resize(Count);
+        jobs.ParallelFor(Count, BuildGrain, [this, invCellSize](int, int begin, int end)
+        {
+            for (int i = begin; i < end; i++)
+                CellRange(X[i], Y[i], Z[i], Radius[i], invCellSize, CellMin[i], CellMax[i]);
+        });
+
+        int numEntries = 0;
+        for (int k = 0; k < NumMembers; k++)
+        {
+            const int i = GetMember(k);
+            numEntries += (CellMax[i].x - CellMin[i].x + 1) * (CellMax[i].y - CellMin[i].y + 1) * (CellMax[i].z - CellMin[i].z + 1);
+        }
+
+        // 2. 해시 테이블 크기는 항목 수의 2배 이상인 2의 거듭제곱
+        int tableSize = 1;
+        while (tableSize < numEntries * 2) tableSize <<= 1;
+        TableMask = tableSize - 1;
+
+        // 3. 버킷별 개수를 세고 누적합으로 시작 위치를 구한다 (counting sort)
+        BucketStart.assign(tableSize + 1, 0);
+        ForEachEntry([this](int bucket, int) { BucketStart[bucket + 1]++; });
+        for (int b = 0; b < tableSize; b++)
+            BucketStart[b + 1] += BucketStart[b];
+
+        Entries.resize(numEntries);
+        BucketFill.assign(BucketStart.begin(), BucketStart.end() - 1);
+        ForEachEntry([this](int bucket, int ball) { Entries[BucketFill[bucket]++] = ball; });
+    }
+
+    // 질의 공을 덩어리로 나눠 병렬로 찾고, 덩어리 순서대로 이어 붙여 순서를 유지한다
+    template <typename QueryFunc, typename AcceptFunc>
+    void CollectPairs(FJobSystem& jobs, int numQueries, std::vector<FCollisionPair>& outPairs, QueryFunc query, AcceptFunc accept)
+    {
+        const int numChunks = jobs.GetNumChunks(numQueries, QueryGrain);
+        if ((int)ChunkPairs.size() < numChunks)
+        {
+            ChunkPairs.resize(numChunks);
+            ChunkCandidates.resize(numChunks);
+        }
+
+        jobs.ParallelFor(numQueries, QueryGrain, [this, &query, &accept](int chunk, int begin, int end)
+        {
+            std::vector<FCollisionPair>& pairs = ChunkPairs[chunk];
+            std::vector<int>& candidates = ChunkCandidates[chunk];
+            pairs.clear();
+            for (int q = begin; q < end; q++)
+            {
+                const int i = query(q);
+                GatherCandidates(i, candidates, accept);
+                for (int j : candidates)
+                    pairs.push_back({ std::min(i, j), std::max(i, j) });
+            }
+        });
+
+        size_t numPairs = 0;
+        for (int c = 0; c < numChunks; c++)
+            numPairs += ChunkPairs[c].size();
+        outPairs.reserve(numPairs);
+        for (int c = 0; c < numChunks; c++)
+            outPairs.insert(outPairs.end(), ChunkPairs[c].begin(), ChunkPairs[c].end());
+    }
+
+    // i와 AABB가 겹치고 accept(i, j)를 만족하는 j를 candidates에 한 번씩 채운다
+    template <typename AcceptFunc>
+    void GatherCandidates(int i, std::vector<int>& candidates, const AcceptFunc& accept) const
+    {
+        candidates.clear();
+        const FCell& lo = CellMin[i];
+        const FCell& hi = CellMax[i];
+        for (int cz = lo.z; cz <= hi.z; cz++)
+        for (int cy = lo.y; cy <= hi.y; cy++)
+        for (int cx = lo.x; cx <= hi.x; cx++)
+        {
+            const int bucket = Hash(cx, cy, cz);
+            for (int e = BucketStart[bucket]; e < BucketStart[bucket + 1]; e++)
+            {
+                const int j = Entries[e];
+                if (j == i || !accept(i, j)) continue;
+
+                // 버킷 안의 항목은 공 순서로 채워지므로, j의 여러 셀이 같은 버킷에 해시되면 바로 앞 항목도 j다
+                if (e > BucketStart[bucket] && Entries[e - 1] == j) continue;
+
+                // 해시 충돌로 섞여 들어온 다른 셀의 공은 제외하고,
+                // 두 범위가 공유하는 첫 셀에서만 받아 중복을 없앤다
+                const FCell& jlo = CellMin[j];
+                const FCell& jhi = CellMax[j];
+                if (cx < jlo.x || cx > jhi.x || cy < jlo.y || cy > jhi.y || cz < jlo.z || cz > jhi.z) continue;
+                if (cx != std::max(lo.x, jlo.x) || cy != std::max(lo.y, jlo.y) || cz != std::max(lo.z, jlo.z)) continue;
+
+                // AABB 겹침 검사 (구 판정은 좁은 단계에서)
+                const float reach = Radius[i] + Radius[j];
+                if (fabsf(X[j] - X[i]) > reach || fabsf(Y[j] - Y[i]) > reach || fabsf(Z[j] - Z[i]) > reach) continue;
+
+                candidates.push_back(j);
+            }
+        }
+    }
+
+    // 셀 크기는 평균 지름을 기본으로 하되, 가장 큰 공이 축마다 몇 칸 이상 걸치지 않도록 제한한다
+    // 모든 공이 같은 z 평면에 있는지도 여기서 본다
+    void ComputeCellSize()
+    {
+        double sum = 0.0;
+        float maxRadius = 0.0f;
+        bFlat = true;
+        for (int i = 0; i < Count; i++)
+        {
+            sum += Radius[i];
+            maxRadius = std::max(maxRadius, Radius[i]);
+            bFlat = bFlat && Z[i] == Z[0];
+        }
+        const float meanRadius = (float)(sum / Count);
+        CellSize = std::max(std::max(2.0f * meanRadius, 0.5f * maxRadius), 1e-4f);
+    }
+
+    // 2D에서는 z = 0 평면에 걸친 공이 z 셀 두 개에 들어가지 않도록 z 셀을 0 하나로 둔다
+    void CellRange(float px, float py, float pz, float r, float invCellSize, FCell& outMin, FCell& outMax) const
+    {
+        outMin = { (int)floorf((px - r) * invCellSize), (int)floorf((py - r) * invCellSize), bFlat ? 0 : (int)floorf((pz - r) * invCellSize) };
+        outMax = { (int)floorf((px + r) * invCellSize), (int)floorf((py + r) * invCellSize), bFlat ? 0 : (int)floorf((pz + r) * invCellSize) };
+    }
+
+    int Hash(int cx, int cy, int cz) const
+    {
+        const uint32_t h = ((uint32_t)cx * 73856093u) ^ ((uint32_t)cy * 19349663u) ^ ((uint32_t)cz * 83492791u);
+        return (int)(h & (uint32_t)TableMask);
+    }
+
+    int GetMember(int k) const
+    {
+        return Members ? Members[k] : k;
+    }
+
+    // members는 오름차순이어야 버킷 안의 항목이 공 순서로 채워진다 (GatherCandidates의 중복 제거가 이를 쓴다)
+    template <typename Func>
+    void ForEachEntry(Func func) const
+    {
+        for (int k = 0; k < NumMembers; k++)
+        {
+            const int i = GetMember(k);
+            for (int cz = CellMin[i].z; cz <= CellMax[i].z; cz++)
+            for (int cy = CellMin[i].y; cy <= CellMax[i].y; cy++)
+            for (int cx = CellMin[i].x; cx <= CellMax[i].x; cx++)
+                func(Hash(cx, cy, cz), i);
+        }
+    }
+
+    const float* X = nullptr;
+    const float* Y = nullptr;
+    const float* Z = nullptr;
+    const float* Radius = nullptr;
+    int Count = 0;
+    const int* Members = nullptr; // 격자에 넣은 공 (nullptr이면 0 ~ Count - 1)
+    int NumMembers = 0;
+    int TableMask = 0;
+    bool bFlat = false; // 모든 공의 z가 같음 (2D 모드)
+
+    std::vector<FCell> CellMin;
+    std::vector<FCell> CellMax;
+    std::vector<int> BucketStart;
+    std::vector<int> BucketFill;
+    std::vector<int> Entries;
+    std::vector<std::vector<FCollisionPair>> ChunkPairs; // 덩어리별 결과
+    std::vector<std::vector<int>> ChunkCandidates;
+};
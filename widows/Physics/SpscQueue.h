@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// 생산자 하나, 소비자 하나인 잠금 없는 고정 크기 원형 큐
+// 생산자만 Tail을, 소비자만 Head를 쓰므로 원자 변수 두 개의 acquire/release만으로 충분하다.
+// 두 인덱스는 서로 다른 캐시 줄에 두어 양쪽 스레드가 같은 줄을 두고 다투지 않게 한다.
+template <typename T, int Capacity>
+class TSpscQueue
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // 생산자 스레드에서만 부른다. 큐가 가득 차면 false
+    bool Push(const T& item)
+    {
+        const uint32_t tail = Tail.load(std::memory_order_relaxed);
+        if (tail - Head.load(std::memory_order_acquire) == (uint32_t)Capacity) return false;
+
+        Items[tail & Mask] = item;
+        Tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 소비자 스레드에서만 부른다. 비어 있으면 false
+    bool Pop(T& outItem)
+    {
+        const uint32_t head = Head.load(std::memory_order_relaxed);
+        if (head == Tail.load(std::memory_order_acquire)) return false;
+
+        outItem = Items[head & Mask];
+        Head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    static const uint32_t Mask = (uint32_t)Capacity - 1;
+
+    alignas(64) std::atomic<uint32_t> Head{ 0 }; // 다음에 꺼낼 위치 (소비자)
+    alignas(64) std::atomic<uint32_t> Tail{ 0 }; // 다음에 넣을 위치 (생산자)
+    T Items[Capacity];
+};
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cfloat>
+
+#include "Vector.h"
+
+// 움직이지 않는 물체들을 위한 정적 AABB 계층 (한 번 만들고 질의만 한다)
+// 중심이 가장 넓게 퍼진 축에서 중앙값으로 나누어 위에서부터 만들고, 노드를 깊이 우선 순서로 한 배열에 둔다.
+// 왼쪽 자식은 항상 바로 다음 노드라서 오른쪽 자식 번호만 저장하며, 질의는 고정 크기 스택으로 돈다.
+class FStaticBvh
+{
+public:
+    // 잎 하나에 넣는 최대 물체 수
+    static const int MaxLeafSize = 2;
+
+    // 물체 count개의 AABB로 계층을 새로 만든다 (질의 결과는 여기서 준 물체 번호)
+    void Build(const FVector* boxMin, const FVector* boxMax, int count)
+    {
+        Nodes.clear();
+        Items.resize(count);
+        Centers.resize(count);
+        ItemMin.assign(boxMin, boxMin + count);
+        ItemMax.assign(boxMax, boxMax + count);
+        for (int i = 0; i < count; i++)
+        {
+            Items[i] = i;
+            Centers[i] = (boxMin[i] + boxMax[i]) * 0.5f;
+        }
+        if (count == 0) return;
+
+        Nodes.reserve(2 * count);
+        BuildNode(0, count);
+    }
+
+    bool IsEmpty() const { return Nodes.empty(); }
+    int GetNumNodes() const { return (int)Nodes.size(); }
+
+    // 상자와 AABB가 겹치는 물체마다 visit(item)을 부른다
+    template <typename VisitFunc>
+    void QueryAABB(const FVector& boxMin, const FVector& boxMax, const VisitFunc& visit) const
+    {
+        if (Nodes.empty()) return;
+
+        int stack[StackSize];
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0)
+        {
+            const int index = stack[--top];
+            const FNode& node = Nodes[index];
+            if (!Overlaps(node.Min, node.Max, boxMin, boxMax)) continue;
+
+            if (node.Count > 0)
+            {
+                for (int k = node.First; k < node.First + node.Count; k++)
+                {
+                    const int item = Items[k];
+                    if (Overlaps(ItemMin[item], ItemMax[item], boxMin, boxMax))
+                        visit(item);
+                }
+                continue;
+            }
+            if (top + 2 > StackSize) continue; // 중앙값으로 나누므로 깊이는 log2(n) 정도라 넘칠 일이 없다
+            stack[top++] = node.Right;
+            stack[top++] = index + 1;
+        }
+    }
+
+private:
+    struct FNode
+    {
+        FVector Min;
+        FVector Max;
+        int Right; // 안쪽 노드의 오른쪽 자식 (왼쪽은 바로 다음 노드)
+        int First; // 잎이 가리키는 Items 범위
+        int Count; // 잎의 물체 수 (안쪽 노드는 0)
+    };
+
+    static const int StackSize = 64;
+
+    static bool Overlaps(const FVector& minA, const FVector& maxA, const FVector& minB, const FVector& maxB)
+    {
+        return minA.x <= maxB.x && maxA.x >= minB.x &&
+               minA.y <= maxB.y && maxA.y >= minB.y &&
+               minA.z <= maxB.z && maxA.z >= minB.z;
+    }
+
+    // Items[begin, end)를 감싸는 노드를 만들고 필요하면 둘로 나눠 자식을 만든다
+    void BuildNode(int begin, int end)
+    {
+        const int index = (int)Nodes.size();
+        Nodes.push_back(FNode());
+
+        FVector boxMin(FLT_MAX, FLT_MAX, FLT_MAX);
+        FVector boxMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+        FVector centerMin = boxMin;
+        FVector centerMax = boxMax;
+        for (int k = begin; k < end; k++)
+        {
+            const int item = Items[k];
+            boxMin = FVector(std::min(boxMin.x, ItemMin[item].x), std::min(boxMin.y, ItemMin[item].y), std::min(boxMin.z, ItemMin[item].z));
+            boxMax = FVector(std::max(boxMax.x, ItemMax[item].x), std::max(boxMax.y, ItemMax[item].y), std::max(boxMax.z, ItemMax[item].z));
+            const FVector& c = Centers[item];
+            centerMin = FVector(std::min(centerMin.x, c.x), std::min(centerMin.y, c.y), std::min(centerMin.z, c.z));
+            centerMax = FVector(std::max(centerMax.x, c.x), std::max(centerMax.y, c.y), std::max(centerMax.z, c.z));
+        }
+        Nodes[index].Min = boxMin;
+        Nodes[index].Max = boxMax;
+
+        if (end - begin <= MaxLeafSize)
+        {
+            Nodes[index].Right = -1;
+            Nodes[index].First = begin;
+            Nodes[index].Count = end - begin;
+            return;
+        }
+
+        // 중심이 가장 넓게 퍼진 축에서 절반씩 나눈다
+        const FVector spread = centerMax - centerMin;
+        const int axis = spread.x >= spread.y && spread.x >= spread.z ? 0 : (spread.y >= spread.z ? 1 : 2);
+        const int middle = (begin + end) / 2;
+        std::nth_element(Items.begin() + begin, Items.begin() + middle, Items.begin() + end,
+            [this, axis](int l, int r)
+            {
+                const FVector& cl = Centers[l];
+                const FVector& cr = Centers[r];
+                return axis == 0 ? cl.x < cr.x : (axis == 1 ? cl.y < cr.y : cl.z < cr.z);
+            });
+
+        BuildNode(begin, middle);
+        Nodes[index].Right = (int)Nodes.size();
+        Nodes[index].First = 0;
+        Nodes[index].Count = 0;
+        BuildNode(middle, end);
+    }
+
+    std::vector<FNode> Nodes;
+    std::vector<int> Items;       // 잎 순서로 늘어놓은 물체 번호
+    std::vector<FVector> Centers; // 만들 때만 쓰는 AABB 중심
+    std::vector<FVector> ItemMin;
+    std::vector<FVector> ItemMax;
+};
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+#include "Vector.h"
+#include "Contact.h"
+#include "Primitive.h"
+#include "PrimitivePool.h"
+#include "StaticBvh.h"
+#include "SignedDistanceField.h"
+#include "BallWorld.h"
+#include "JobSystem.h"
+
+// 장면에 놓이는 움직이지 않는 장애물 모음 (평면, 회전된 상자, 캡슐, 볼록 다각형 기둥)
+// 도형은 종류별 풀에서 만들고, Build에서 끝이 있는 도형들로 정적 BVH를 한 번 만든다.
+// 공 하나의 검사는 BVH에서 AABB가 겹치는 장애물만 골라 도형 충돌 표로 푸므로, 장애물이 수백 개여도 공마다 전부 훑지 않는다.
+// 끝없는 평면은 BVH에 넣을 수 없어서 따로 두고 모든 공과 검사한다 (몇 개 안 된다고 본다).
+// 상자 안쪽의 용기 모양(원, 오목한 다각형, 그림)은 부호 거리장 하나로 두고 공마다 한 번 찍어 본다.
+class FStaticObstacles
+{
+public:
+    // 용기 접촉에 쓰는 장애물 번호 (장애물 번호와 겹치지 않는 큰 값)
+    static const int ContainerObstacle = 0x70000000;
+
+    // 공이 있을 수 있는 영역 (비어 있으면 [-1, 1] 상자 벽만 쓴다)
+    FSignedDistanceField Container;
+
+    float ContactSlop = 0.001f; // 이만큼 떨어져 있어도 접촉으로 만들어 쌓인 공이 떨리지 않게 한다
+
+    int NumCandidates = 0; // 마지막 FindContacts에서 BVH가 골라 도형 검사까지 간 (공, 장애물) 쌍 수
+
+    UPlane* AddPlane(const FVector& normal, float distance)
+    {
+        return Register(Planes.Create(normal, distance));
+    }
+
+    // angle은 z축 기준 회전 (라디안)
+    UBox* AddBox(const FVector& center, const FVector& halfExtent, float angle = 0.0f)
+    {
+        UBox* box = Boxes.Create(center, halfExtent);
+        box->SetRotationZ(angle);
+        return Register(box);
+    }
+
+    UCapsule* AddCapsule(const FVector& start, const FVector& end, float radius)
+    {
+        return Register(Capsules.Create(start, end, radius));
+    }
+
+    // 꼭짓점은 xy 평면에 반시계 방향
+    UConvexPolygon* AddPolygon(const FVector* vertices, int numVertices, float halfDepth = 1.0f)
+    {
+        return Register(Polygons.Create(vertices, numVertices, halfDepth));
+    }
+
+    void Clear()
+    {
+        Obstacles.clear();
+        Unbounded.clear();
+        Bounded.clear();
+        Planes.Clear();
+        Boxes.Clear();
+        Capsules.Clear();
+        Polygons.Clear();
+        Bvh.Build(nullptr, nullptr, 0);
+    }
+
+    // 장애물을 다 넣은 뒤에 한 번 부른다 (Add 뒤에 Build 전까지는 질의에 반영되지 않는다)
+    void Build()
+    {
+        Unbounded.clear();
+        Bounded.clear();
+        std::vector<FVector> boxMin;
+        std::vector<FVector> boxMax;
+        for (int i = 0; i < (int)Obstacles.size(); i++)
+        {
+            FVector lo, hi;
+            if (Obstacles[i]->GetBounds(lo, hi))
+            {
+                Bounded.push_back(i);
+                boxMin.push_back(lo);
+                boxMax.push_back(hi);
+            }
+            else
+            {
+                Unbounded.push_back(i);
+            }
+        }
+        Bvh.Build(boxMin.data(), boxMax.data(), (int)Bounded.size());
+    }
+
+    bool IsEmpty() const { return Obstacles.empty(); }
+    int GetNumObstacles() const { return (int)Obstacles.size(); }
+    const UPrimitive* GetObstacle(int index) const { return Obstacles[index]; }
+    int GetNumBvhNodes() const { return Bvh.GetNumNodes(); }
+
+    // 구가 어떤 장애물과라도 겹치거나 용기 밖으로 나가는지 (공을 뿌릴 때 빈자리 검사)
+    bool Overlaps(const USphere& sphere) const
+    {
+        if (!Container.IsEmpty() && Container.Sample(sphere.Center) < sphere.Radius)
+            return true;
+
+        bool bOverlaps = false;
+        ForEachCandidate(sphere, [&sphere, &bOverlaps](int, const UPrimitive* obstacle)
+        {
+            if (!bOverlaps && sphere.Collision(obstacle))
+                bOverlaps = true;
+        });
+        return bOverlaps;
+    }
+
+    // 깨어 있는 공과 장애물의 접촉을 찾아 outContacts에 채운다
+    // 덩어리마다 따로 모았다가 덩어리 순서대로 이어 붙이므로 스레드 수와 관계없이 순서가 같다
+    void FindContacts(const FBallWorld& world, const std::vector<int>& awakeBalls, FJobSystem& jobs, std::vector<FObstacleContact>& outContacts)
+    {
+        outContacts.clear();
+        NumCandidates = 0;
+        if (Obstacles.empty() && Container.IsEmpty()) return;
+
+        const int numBalls = (int)awakeBalls.size();
+        const int numChunks = jobs.GetNumChunks(numBalls, ContactGrain);
+        if ((int)ChunkContacts.size() < numChunks)
+            ChunkContacts.resize(numChunks);
+        ChunkCandidates.assign(numChunks, 0);
+
+        jobs.ParallelFor(numBalls, ContactGrain, [this, &world, &awakeBalls](int chunk, int begin, int end)
+        {
+            std::vector<FObstacleContact>& contacts = ChunkContacts[chunk];
+            contacts.clear();
+            int numCandidates = 0;
+            for (int k = begin; k < end; k++)
+            {
+                const int i = awakeBalls[k];
+                // 반지름을 ContactSlop만큼 키워서 검사하고 깊이에서 다시 뺀다
+                const USphere sphere(FVector(world.PosX[i], world.PosY[i], world.PosZ[i]), world.Radius[i] + ContactSlop);
+                if (!Container.IsEmpty())
+                    AddContainerContact(i, sphere, contacts);
+                ForEachCandidate(sphere, [this, i, &sphere, &contacts, &numCandidates](int index, const UPrimitive* obstacle)
+                {
+                    numCandidates++;
+                    FShapeContact shapeContact;
+                    if (!sphere.Collision(obstacle, &shapeContact)) return;
+                    contacts.push_back({ i, index,
+                        shapeContact.Normal.x, shapeContact.Normal.y, shapeContact.Normal.z,
+                        shapeContact.Penetration - ContactSlop });
+                });
+            }
+            ChunkCandidates[chunk] = numCandidates;
+        });
+
+        for (int chunk = 0; chunk < numChunks; chunk++)
+        {
+            outContacts.insert(outContacts.end(), ChunkContacts[chunk].begin(), ChunkContacts[chunk].end());
+            NumCandidates += ChunkCandidates[chunk];
+        }
+    }
+
+    // 모든 장애물과 용기의 외곽선 (선분 양 끝점이 두 개씩)
+    void GetOutline(std::vector<FVector>& outLines) const
+    {
+        Container.GetOutline(outLines);
+        for (const UPrimitive* obstacle : Obstacles)
+            obstacle->GetOutline(outLines);
+    }
+
+private:
+    static const int ContactGrain = 1024; // 접촉 찾기 잡 하나가 맡는 공 수
+
+    template <typename T>
+    T* Register(T* obstacle)
+    {
+        Obstacles.push_back(obstacle);
+        return obstacle;
+    }
+
+    // 거리장 한 번으로 벽까지의 거리와 방향을 얻는다 (기울기는 안쪽을 향하므로 법선은 그 반대)
+    void AddContainerContact(int i, const USphere& sphere, std::vector<FObstacleContact>& contacts) const
+    {
+        float distance;
+        FVector gradient;
+        Container.SampleWithGradient(sphere.Center, distance, gradient);
+        if (distance >= sphere.Radius) return;
+
+        const FVector normal = gradient.GetSafeNormal() * -1.0f;
+        if (normal.SizeSquared() == 0.0f) return;
+        contacts.push_back({ i, ContainerObstacle, normal.x, normal.y, normal.z, sphere.Radius - distance - ContactSlop });
+    }
+
+    // 구와 AABB가 겹치는 장애물마다 func(장애물 번호, 장애물)을 부른다 (평면은 항상)
+    template <typename Func>
+    void ForEachCandidate(const USphere& sphere, const Func& func) const
+    {
+        for (int index : Unbounded)
+            func(index, Obstacles[index]);
+
+        const FVector extent(sphere.Radius, sphere.Radius, sphere.Radius);
+        Bvh.QueryAABB(sphere.Center - extent, sphere.Center + extent, [this, &func](int item)
+        {
+            const int index = Bounded[item];
+            func(index, Obstacles[index]);
+        });
+    }
+
+    TPrimitivePool<UPlane> Planes;
+    TPrimitivePool<UBox> Boxes;
+    TPrimitivePool<UCapsule> Capsules;
+    TPrimitivePool<UConvexPolygon> Polygons;
+
+    std::vector<UPrimitive*> Obstacles; // 추가한 순서 (접촉의 장애물 번호)
+    std::vector<int> Unbounded;         // BVH에 넣지 않은 장애물 번호
+    std::vector<int> Bounded;           // BVH 물체 번호 -> 장애물 번호
+    FStaticBvh Bvh;
+
+    std::vector<std::vector<FObstacleContact>> ChunkContacts;
+    std::vector<int> ChunkCandidates;
+};
@@ -0,0 +1,240 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <cstdint>
+
+#include "Contact.h"
+
+// 점진적 Sweep and Prune 브로드페이즈
+// 축마다 AABB 끝점(최소/최대)을 정렬해 두고, 매 프레임 새 위치로 값만 바꾼 뒤 삽입 정렬로 다시 정렬한다.
+// 공이 조금씩만 움직이면 순서도 거의 그대로이므로, 비용은 공 수 + 순서가 바뀐 횟수에 비례한다.
+// 최소 끝점이 다른 공의 최대 끝점을 넘어가면 그 축에서 겹치기 시작한 것이고, 반대면 떨어진 것이다.
+// 이 교차를 겹침 쌍의 추가/제거 이벤트로 모아 정렬된 쌍 목록을 갱신한다.
+class FSweepAndPrune
+{
+public:
+    int NumSwaps = 0;                        // 마지막 Update에서 끝점 순서가 바뀐 횟수
+    std::vector<FCollisionPair> AddedPairs;   // 마지막 Update에서 새로 겹친 쌍
+    std::vector<FCollisionPair> RemovedPairs; // 마지막 Update에서 떨어진 쌍
+
+    // 공 인덱스가 바뀌었을 때(추가/제거/재배치) 호출하면 다음 Update에서 처음부터 다시 만든다
+    void Invalidate()
+    {
+        bValid = false;
+    }
+
+    // 현재 위치로 끝점 목록과 겹침 쌍을 갱신한다
+    void Update(const float* x, const float* y, const float* z, const float* radius, int count)
+    {
+        Pos[0] = x; Pos[1] = y; Pos[2] = z; Radius = radius;
+        AddedPairs.clear();
+        RemovedPairs.clear();
+        NumSwaps = 0;
+
+        if (!bValid || count != Count)
+        {
+            Count = count;
+            Rebuild();
+            return;
+        }
+
+        // 1. 끝점 값만 새 위치로 바꾸고, 축마다 삽입 정렬하면서 교차를 이벤트로 모은다
+        Added.clear();
+        Removed.clear();
+        for (int axis = 0; axis < 3; axis++)
+        {
+            RefreshEndpoints(axis);
+            SortAxis(axis);
+        }
+        if (Added.empty() && Removed.empty()) return;
+
+        // 2. 같은 쌍이 여러 축에서 들어올 수 있으므로 중복을 없앤다
+        SortUnique(Added);
+        SortUnique(Removed);
+
+        // 3. 실제로 있던 쌍만 제거하고, 새 쌍을 정렬 순서를 유지하며 합친다
+        Scratch.clear();
+        std::set_intersection(Pairs.begin(), Pairs.end(), Removed.begin(), Removed.end(), std::back_inserter(Scratch));
+        Removed.swap(Scratch);
+
+        Scratch.clear();
+        std::set_difference(Pairs.begin(), Pairs.end(), Removed.begin(), Removed.end(), std::back_inserter(Scratch));
+        Pairs.clear();
+        std::merge(Scratch.begin(), Scratch.end(), Added.begin(), Added.end(), std::back_inserter(Pairs));
+
+        for (uint64_t key : Added) AddedPairs.push_back(ToPair(key));
+        for (uint64_t key : Removed) RemovedPairs.push_back(ToPair(key));
+    }
+
+    // Update 후 AABB가 겹치는 모든 쌍을 (A, B) 순서로 채운다
+    void FindPairs(const float* x, const float* y, const float* z, const float* radius, int count, std::vector<FCollisionPair>& outPairs)
+    {
+        Update(x, y, z, radius, count);
+        outPairs.resize(Pairs.size());
+        for (size_t p = 0; p < Pairs.size(); p++)
+            outPairs[p] = ToPair(Pairs[p]);
+    }
+
+    // Update 후 한쪽이라도 isQuery인 쌍만 채운다 (잠든 공끼리의 쌍을 뺄 때)
+    void FindPairsFor(const float* x, const float* y, const float* z, const float* radius, int count, const uint8_t* isQuery, std::vector<FCollisionPair>& outPairs)
+    {
+        Update(x, y, z, radius, count);
+        outPairs.clear();
+        for (uint64_t key : Pairs)
+        {
+            const FCollisionPair pair = ToPair(key);
+            if (isQuery[pair.A] || isQuery[pair.B])
+                outPairs.push_back(pair);
+        }
+    }
+
+    int GetNumPairs() const { return (int)Pairs.size(); }
+
+private:
+    // 끝점: 값과 (공 인덱스 << 1 | 최대 끝점이면 1)
+    struct FEndpoint
+    {
+        float Value;
+        uint32_t Data;
+
+        int GetBall() const { return (int)(Data >> 1); }
+        bool IsMax() const { return (Data & 1) != 0; }
+    };
+
+    // 값이 같으면 최소 끝점을 앞에 둔다 (맞닿은 AABB도 겹친 것으로 보는 FSpatialHash와 맞춤)
+    static bool Less(const FEndpoint& l, const FEndpoint& r)
+    {
+        if (l.Value != r.Value) return l.Value < r.Value;
+        return !l.IsMax() && r.IsMax();
+    }
+
+    static uint64_t MakeKey(int a, int b)
+    {
+        if (a > b) std::swap(a, b);
+        return ((uint64_t)(uint32_t)a << 32) | (uint32_t)b;
+    }
+
+    static FCollisionPair ToPair(uint64_t key)
+    {
+        return { (int)(key >> 32), (int)(key & 0xFFFFFFFFu) };
+    }
+
+    static void SortUnique(std::vector<uint64_t>& keys)
+    {
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    }
+
+    bool OverlapOnAxis(int axis, int a, int b) const
+    {
+        const float* p = Pos[axis];
+        return p[a] - Radius[a] <= p[b] + Radius[b] && p[b] - Radius[b] <= p[a] + Radius[a];
+    }
+
+    bool Overlap(int a, int b) const
+    {
+        return OverlapOnAxis(0, a, b) && OverlapOnAxis(1, a, b) && OverlapOnAxis(2, a, b);
+    }
+
+    void RefreshEndpoints(int axis)
+    {
+        const float* p = Pos[axis];
+        for (FEndpoint& e : Axes[axis])
+        {
+            const int i = e.GetBall();
+            e.Value = e.IsMax() ? p[i] + Radius[i] : p[i] - Radius[i];
+        }
+    }
+
+    // 거의 정렬된 목록을 삽입 정렬한다. 끝점이 왼쪽으로 지나칠 때마다 겹침이 바뀌었는지 본다
+    void SortAxis(int axis)
+    {
+        std::vector<FEndpoint>& list = Axes[axis];
+        for (int k = 1; k < (int)list.size(); k++)
+        {
+            const FEndpoint e = list[k];
+            int j = k;
+            while (j > 0 && Less(e, list[j - 1]))
+            {
+                const FEndpoint& prev = list[j - 1];
+                if (!e.IsMax() && prev.IsMax())
+                {
+                    // 최소 끝점이 다른 공의 최대 끝점 앞으로: 이 축에서 겹치기 시작
+                    if (Overlap(e.GetBall(), prev.GetBall()))
+                        Added.push_back(MakeKey(e.GetBall(), prev.GetBall()));
+                }
+                else if (e.IsMax() && !prev.IsMax())
+                {
+                    // 최대 끝점이 다른 공의 최소 끝점 앞으로: 이 축에서 떨어짐
+                    Removed.push_back(MakeKey(e.GetBall(), prev.GetBall()));
+                }
+                list[j] = prev;
+                j--;
+                NumSwaps++;
+            }
+            list[j] = e;
+        }
+    }
+
+    // 끝점 목록을 새로 만들어 정렬하고, x축을 쓸어 가며 겹치는 쌍을 처음부터 찾는다
+    void Rebuild()
+    {
+        for (int axis = 0; axis < 3; axis++)
+        {
+            std::vector<FEndpoint>& list = Axes[axis];
+            list.resize(Count * 2);
+            for (int i = 0; i < Count; i++)
+            {
+                list[i * 2] = { 0.0f, (uint32_t)i << 1 };
+                list[i * 2 + 1] = { 0.0f, ((uint32_t)i << 1) | 1 };
+            }
+            RefreshEndpoints(axis);
+            std::sort(list.begin(), list.end(), Less);
+        }
+
+        // x축에서 열려 있는 공들과만 나머지 축을 검사
+        Pairs.clear();
+        Active.clear();
+        ActiveSlot.assign(Count, -1);
+        for (const FEndpoint& e : Axes[0])
+        {
+            const int i = e.GetBall();
+            if (e.IsMax())
+            {
+                const int slot = ActiveSlot[i];
+                const int last = Active.back();
+                Active[slot] = last;
+                ActiveSlot[last] = slot;
+                Active.pop_back();
+                continue;
+            }
+
+            for (int j : Active)
+            {
+                if (OverlapOnAxis(1, i, j) && OverlapOnAxis(2, i, j))
+                    Pairs.push_back(MakeKey(i, j));
+            }
+            ActiveSlot[i] = (int)Active.size();
+            Active.push_back(i);
+        }
+        std::sort(Pairs.begin(), Pairs.end());
+
+        for (uint64_t key : Pairs) AddedPairs.push_back(ToPair(key));
+        bValid = true;
+    }
+
+    const float* Pos[3] = { nullptr, nullptr, nullptr };
+    const float* Radius = nullptr;
+    int Count = 0;
+    bool bValid = false;
+
+    std::vector<FEndpoint> Axes[3];
+    std::vector<uint64_t> Pairs;   // 지금 겹치는 쌍의 키 (정렬됨)
+    std::vector<uint64_t> Added;
+    std::vector<uint64_t> Removed;
+    std::vector<uint64_t> Scratch;
+    std::vector<int> Active;       // Rebuild 중 x축에서 열려 있는 공
+    std::vector<int> ActiveSlot;
+};
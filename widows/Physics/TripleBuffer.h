@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+
+// 쓰는 스레드 하나와 읽는 스레드 하나가 잠금 없이 최신 값을 주고받는 삼중 버퍼
+// 쓰는 쪽과 읽는 쪽이 버퍼를 하나씩 붙잡고, 세 번째 버퍼를 원자적으로 맞바꿔 건넨다.
+// 쓰는 쪽은 읽는 쪽을 기다리지 않고, 읽는 쪽은 항상 마지막으로 완성된 버퍼를 통째로 본다 (중간 값은 건너뛸 수 있다).
+template <typename T>
+class TTripleBuffer
+{
+public:
+    // 쓰는 스레드가 채울 버퍼
+    T& GetWriteBuffer() { return Buffers[WriteIndex]; }
+
+    // 다 채운 버퍼를 내보내고 가운데 버퍼를 새로 받는다 (읽히지 않은 이전 값은 덮어써진다)
+    void Publish()
+    {
+        WriteIndex = Shared.exchange(WriteIndex | NewBit, std::memory_order_acq_rel) & IndexMask;
+    }
+
+    // 새로 나온 버퍼가 있으면 읽는 버퍼로 가져오고 true를 반환한다
+    bool Acquire()
+    {
+        if (!(Shared.load(std::memory_order_relaxed) & NewBit)) return false;
+        ReadIndex = Shared.exchange(ReadIndex, std::memory_order_acq_rel) & IndexMask;
+        return true;
+    }
+
+    // 읽는 스레드가 보는 버퍼 (다음 Acquire까지 바뀌지 않는다)
+    const T& GetReadBuffer() const { return Buffers[ReadIndex]; }
+
+private:
+    static const int IndexMask = 3;
+    static const int NewBit = 4; // 가운데 버퍼가 아직 읽히지 않은 새 값인지
+
+    T Buffers[3];
+    int WriteIndex = 0;
+    int ReadIndex = 1;
+    std::atomic<int> Shared{ 2 };
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cmath>
+
+// Structure for a 3D vector
+struct FVector
+{
+    float x, y, z;
+
+    FVector(float _x = 0, float _y = 0, float _z = 0)
+        : x(_x), y(_y), z(_z) {
+    }
+
+    // --- 기본 연산자 ---
+    FVector operator+(const FVector& rhs) const { return FVector(x + rhs.x, y + rhs.y, z + rhs.z); }
+    FVector operator-(const FVector& rhs) const { return FVector(x - rhs.x, y - rhs.y, z - rhs.z); }
+    FVector operator*(float s) const { return FVector(x * s, y * s, z * s); }
+    FVector operator/(float s) const { return FVector(x / s, y / s, z / s); }
+
+    FVector& operator+=(const FVector& rhs) { x += rhs.x; y += rhs.y; z += rhs.z; return *this; }
+    FVector& operator-=(const FVector& rhs) { x -= rhs.x; y -= rhs.y; z -= rhs.z; return *this; }
+    FVector& operator*=(float s) { x *= s; y *= s; z *= s; return *this; }
+
+    // --- 물리/기하 연산 ---
+
+    // 1. 내적 (Dot Product): 두 벡터 사이의 각도나 투영 길이를 구할 때 사용
+    float Dot(const FVector& rhs) const {
+        return x * rhs.x + y * rhs.y + z * rhs.z;
+    }
+
+    // 2. 외적 (Cross Product): 두 벡터에 수직인 벡터(법선 벡터)를 구할 때 사용
+    FVector Cross(const FVector& rhs) const {
+        return FVector(
+            y * rhs.z - z * rhs.y,
+            z * rhs.x - x * rhs.z,
+            x * rhs.y - y * rhs.x
+        );
+    }
+
+    // 3. 길이의 제곱: 거리 비교 시 루트 연산을 피하기 위해 사용 (성능 최적화)
+    float SizeSquared() const {
+        return x * x + y * y + z * z;
+    }
+
+    // 4. 실제 길이 (Magnitude)
+    float Size() const {
+        return sqrtf(SizeSquared());
+    }
+
+    // 5. 정규화 (Normalize): 방향은 유지하고 길이를 1로 만듦
+    FVector GetSafeNormal() const {
+        float s = Size();
+        if (s > 0.0001f) return *this * (1.0f / s);
+        return FVector(0, 0, 0);
+    }
+};
@@ -2,7 +2,7 @@ cbuffer cbPerObject : register(b0)
 {
     float3 gOffset;
     float  gScale;
-    float3 pad;  // е
+    row_major float4x4 gViewProjection; // 월드 -> 클립 공간 (2D 모드에서는 단위 행렬)
 };
 
 struct VS_INPUT
@@ -20,9 +20,9 @@ struct PS_INPUT
 PS_INPUT mainVS(VS_INPUT input)
 {
     PS_INPUT output;
-    // ġ +  +  
+    // 위치 + 오프셋 + 스케일 적용 후 카메라 변환
     float3 scaledPos = input.Pos * gScale;
-    output.Pos = float4(scaledPos + gOffset, 1.0f);
+    output.Pos = mul(float4(scaledPos + gOffset, 1.0f), gViewProjection);
     output.Color = input.Color;
     return output;
 }
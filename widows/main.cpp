@@ -1,16 +1,16 @@
 #include <Windows.h>
 
-// D3D 뿡 ʿ ̺귯 ũմϴ.
+// D3D 사용에 필요한 라이브러리들을 링크합니다.
 #pragma comment(lib, "user32.lib")
 #pragma comment(lib, "d3d11.lib")
 #pragma comment(lib, "d3dcompiler.lib")
 #pragma comment(lib, "dxgi.lib")
 
-// D3D 뿡 ʿ ϵ մϴ.
+// D3D 사용에 필요한 헤더파일들을 포함합니다.
 #include <d3d11.h>
 #include <d3dcompiler.h>
 
-// ImGui  ϵ մϴ.
+// ImGui 관련 헤더파일들을 포함합니다.
 #include "ImGui/imgui.h"
 #include "ImGui/imgui_internal.h"
 #include "ImGui/imgui_impl_dx11.h"
@@ -22,147 +22,109 @@ struct FVertexSimple
     float x, y, z;    // Position
     float r, g, b, a; // Color
 };
-// Structure for a 3D vector
-struct FVector
-{
-    float x, y, z;
-
-    FVector(float _x = 0, float _y = 0, float _z = 0)
-        : x(_x), y(_y), z(_z) {
-    }
-
-    // --- ⺻  ---
-    FVector operator+(const FVector& rhs) const { return FVector(x + rhs.x, y + rhs.y, z + rhs.z); }
-    FVector operator-(const FVector& rhs) const { return FVector(x - rhs.x, y - rhs.y, z - rhs.z); }
-    FVector operator*(float s) const { return FVector(x * s, y * s, z * s); }
-    FVector operator/(float s) const { return FVector(x / s, y / s, z / s); }
-
-    FVector& operator+=(const FVector& rhs) { x += rhs.x; y += rhs.y; z += rhs.z; return *this; }
-    FVector& operator-=(const FVector& rhs) { x -= rhs.x; y -= rhs.y; z -= rhs.z; return *this; }
-    FVector& operator*=(float s) { x *= s; y *= s; z *= s; return *this; }
-
-    // --- /  ---
-
-    // 1.  (Dot Product):      ̸   
-    float Dot(const FVector& rhs) const {
-        return x * rhs.x + y * rhs.y + z * rhs.z;
-    }
-
-    // 2.  (Cross Product):  Ϳ  ( )   
-    FVector Cross(const FVector& rhs) const {
-        return FVector(
-            y * rhs.z - z * rhs.y,
-            z * rhs.x - x * rhs.z,
-            x * rhs.y - y * rhs.x
-        );
-    }
-
-    // 3.  : Ÿ   Ʈ  ϱ   ( ȭ)
-    float SizeSquared() const {
-        return x * x + y * y + z * z;
-    }
-
-    // 4.   (Magnitude)
-    float Size() const {
-        return sqrtf(SizeSquared());
-    }
-
-    // 5. ȭ (Normalize):  ϰ ̸ 1 
-    FVector GetSafeNormal() const {
-        float s = Size();
-        if (s > 0.0001f) return *this * (1.0f / s);
-        return FVector(0, 0, 0);
-    }
-};
-
-bool EnableGravity = false;           // ߷ / 
-float GravityAcceleration = -9.8f;    // ߷ ӵ (Y  Ʒ)
 
+#include "Physics/Vector.h"
+#include "Physics/Primitive.h"
 #include "Sphere.h"
+#include "Physics/JobSystem.h"
+#include "Physics/BallSimulation.h"
+#include "Physics/SimulationThread.h"
+#include "Physics/FixedTimestep.h"
 
 class URenderer
 {
 public:
-    // Direct3D 11 ġ(Device) ġ ؽƮ(Device Context)   ü(Swap Chain) ϱ  ͵
-    ID3D11Device* Device = nullptr; // GPU ϱ  Direct3D ġ
-    ID3D11DeviceContext* DeviceContext = nullptr; // GPU   ϴ ؽƮ
-    IDXGISwapChain* SwapChain = nullptr; //  ۸ üϴ  Ǵ  ü
-
-    //  ʿ ҽ  ¸ ϱ  
-    ID3D11Texture2D* FrameBuffer = nullptr; // ȭ ¿ ؽó
-    ID3D11RenderTargetView* FrameBufferRTV = nullptr; // ؽó  Ÿ ϴ 
-    ID3D11RasterizerState* RasterizerState = nullptr; // Ͷ (ø, ä   )
-    ID3D11Buffer* ConstantBuffer = nullptr; // ̴ ͸ ϱ   
-
-    FLOAT ClearColor[4] = { 0.025f, 0.025f, 0.025f, 1.0f }; // ȭ ʱȭ(clear)    (RGBA)
-    D3D11_VIEWPORT ViewportInfo; //   ϴ Ʈ 
-
-    ID3D11VertexShader* SimpleVertexShader; //  ̴
-    ID3D11PixelShader* SimplePixelShader;   // ȼ ̴
-    ID3D11InputLayout* SimpleInputLayout;   // IAԷ ̾ƿ
+    // Direct3D 11 장치(Device)와 장치 컨텍스트(Device Context) 및 스왑 체인(Swap Chain)을 관리하기 위한 포인터들
+    ID3D11Device* Device = nullptr; // GPU와 통신하기 위한 Direct3D 장치
+    ID3D11DeviceContext* DeviceContext = nullptr; // GPU 명령 실행을 담당하는 컨텍스트
+    IDXGISwapChain* SwapChain = nullptr; // 프레임 버퍼를 교체하는 데 사용되는 스왑 체인
+
+    // 렌더링에 필요한 리소스 및 상태를 관리하기 위한 변수들
+    ID3D11Texture2D* FrameBuffer = nullptr; // 화면 출력용 텍스처
+    ID3D11RenderTargetView* FrameBufferRTV = nullptr; // 텍스처를 렌더 타겟으로 사용하는 뷰
+    ID3D11Texture2D* DepthBuffer = nullptr; // 깊이 버퍼 (3D 모드에서 앞에 있는 공이 가리도록)
+    ID3D11DepthStencilView* DepthBufferDSV = nullptr;
+    ID3D11RasterizerState* RasterizerState = nullptr; // 래스터라이저 상태(컬링, 채우기 모드 등 정의)
+    ID3D11RasterizerState* RasterizerStateCullFront = nullptr; // 3D 카메라용 (카메라 쪽 반구를 그린다)
+    ID3D11Buffer* ConstantBuffer = nullptr; // 쉐이더에 데이터를 전달하기 위한 상수 버퍼
+
+    FLOAT ClearColor[4] = { 0.025f, 0.025f, 0.025f, 1.0f }; // 화면을 초기화(clear)할 때 사용할 색상 (RGBA)
+    D3D11_VIEWPORT ViewportInfo; // 렌더링 영역을 정의하는 뷰포트 정보
+
+    ID3D11VertexShader* SimpleVertexShader; // 정점 쉐이더
+    ID3D11PixelShader* SimplePixelShader;   // 픽셀 쉐이더
+    ID3D11InputLayout* SimpleInputLayout;   // IA입력 레이아웃
     unsigned int Stride;
     ID3D11Buffer* VertexBufferSphere = nullptr;
     UINT          NumVerticesSphere = 0;
+    ID3D11Buffer* VertexBufferObstacles = nullptr; // 장애물 외곽선 (선분 목록, 배치를 바꿀 때 다시 만든다)
+    UINT          NumVerticesObstacles = 0;
+    // 월드 -> 클립 공간 행렬 (행 벡터 * 행렬). 2D 모드에서는 단위 행렬이라 월드 좌표가 그대로 화면 좌표가 된다
+    float ViewProjection[4][4] = { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 }, { 0, 0, 0, 1 } };
+
     struct FConstants
     {
-        FVector Offset;     // ġ
-        float   Scale;      //    
-        float   Pad[3];     // 16Ʈ  ߱  е
+        FVector Offset;     // 위치
+        float   Scale;      // 각 공의 스케일 팩터
+        float   ViewProjection[4][4]; // 16바이트 경계에서 시작 (셰이더의 row_major float4x4)
     };
 
 public:
-    //  ʱȭ Լ
+    // 렌더러 초기화 함수
     void Create(HWND hWindow)
     {
-        // Direct3D ġ   ü 
+        // Direct3D 장치 및 스왑 체인 생성
         CreateDeviceAndSwapChain(hWindow);
 
-        //   
+        // 프레임 버퍼 생성
         CreateFrameBuffer();
 
-        // Ͷ  
+        // 깊이 버퍼 생성
+        CreateDepthBuffer();
+
+        // 래스터라이저 상태 생성
         CreateRasterizerState();
 
-        //  ٽ    ´  ڵ忡 ٷ 
+        // 스텐실과 블렌드 상태는 이 코드에서는 다루지 않음 (깊이 검사는 기본 상태 사용)
     }
 
-    // Direct3D ġ   ü ϴ Լ
+    // Direct3D 장치 및 스왑 체인을 생성하는 함수
     void CreateDeviceAndSwapChain(HWND hWindow)
     {
-        // ϴ Direct3D   
+        // 지원하는 Direct3D 기능 레벨을 정의
         D3D_FEATURE_LEVEL featurelevels[] = { D3D_FEATURE_LEVEL_11_0 };
 
-        //  ü  ü ʱȭ
+        // 스왑 체인 설정 구조체 초기화
         DXGI_SWAP_CHAIN_DESC swapchaindesc = {};
-        swapchaindesc.BufferDesc.Width = 0; // â ũ⿡ ° ڵ 
-        swapchaindesc.BufferDesc.Height = 0; // â ũ⿡ ° ڵ 
-        swapchaindesc.BufferDesc.Format = DXGI_FORMAT_B8G8R8A8_UNORM; //  
-        swapchaindesc.SampleDesc.Count = 1; // Ƽ ø Ȱȭ
-        swapchaindesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT; //  Ÿ 
-        swapchaindesc.BufferCount = 2; //  ۸
-        swapchaindesc.OutputWindow = hWindow; //  â ڵ
-        swapchaindesc.Windowed = TRUE; // â 
-        swapchaindesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD; //  
-
-        // Direct3D ġ  ü 
+        swapchaindesc.BufferDesc.Width = 0; // 창 크기에 맞게 자동으로 설정
+        swapchaindesc.BufferDesc.Height = 0; // 창 크기에 맞게 자동으로 설정
+        swapchaindesc.BufferDesc.Format = DXGI_FORMAT_B8G8R8A8_UNORM; // 색상 포맷
+        swapchaindesc.SampleDesc.Count = 1; // 멀티 샘플링 비활성화
+        swapchaindesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT; // 렌더 타겟으로 사용
+        swapchaindesc.BufferCount = 2; // 더블 버퍼링
+        swapchaindesc.OutputWindow = hWindow; // 렌더링할 창 핸들
+        swapchaindesc.Windowed = TRUE; // 창 모드
+        swapchaindesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD; // 스왑 방식
+
+        // Direct3D 장치와 스왑 체인을 생성
         D3D11CreateDeviceAndSwapChain(nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr,
             D3D11_CREATE_DEVICE_BGRA_SUPPORT | D3D11_CREATE_DEVICE_DEBUG,
             featurelevels, ARRAYSIZE(featurelevels), D3D11_SDK_VERSION,
             &swapchaindesc, &SwapChain, &Device, nullptr, &DeviceContext);
 
-        //   ü  
+        // 생성된 스왑 체인의 정보 가져오기
         SwapChain->GetDesc(&swapchaindesc);
 
-        // Ʈ  
+        // 뷰포트 정보 설정
         ViewportInfo = { 0.0f, 0.0f, (float)swapchaindesc.BufferDesc.Width, (float)swapchaindesc.BufferDesc.Height, 0.0f, 1.0f };
     }
 
-    // Direct3D ġ   ü ϴ Լ
+    // Direct3D 장치 및 스왑 체인을 해제하는 함수
     void ReleaseDeviceAndSwapChain()
     {
         if (DeviceContext)
         {
-            DeviceContext->Flush(); // ִ GPU  
+            DeviceContext->Flush(); // 남아있는 GPU 명령 실행
         }
 
         if (SwapChain)
@@ -184,21 +146,21 @@ public:
         }
     }
 
-    //  ۸ ϴ Լ
+    // 프레임 버퍼를 생성하는 함수
     void CreateFrameBuffer()
     {
-        //  üκ   ؽó 
+        // 스왑 체인으로부터 백 버퍼 텍스처 가져오기
         SwapChain->GetBuffer(0, __uuidof(ID3D11Texture2D), (void**)&FrameBuffer);
 
-        //  Ÿ  
+        // 렌더 타겟 뷰 생성
         D3D11_RENDER_TARGET_VIEW_DESC framebufferRTVdesc = {};
-        framebufferRTVdesc.Format = DXGI_FORMAT_B8G8R8A8_UNORM_SRGB; //  
-        framebufferRTVdesc.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2D; // 2D ؽó
+        framebufferRTVdesc.Format = DXGI_FORMAT_B8G8R8A8_UNORM_SRGB; // 색상 포맷
+        framebufferRTVdesc.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2D; // 2D 텍스처
 
         Device->CreateRenderTargetView(FrameBuffer, &framebufferRTVdesc, &FrameBufferRTV);
     }
 
-    //  ۸ ϴ Լ
+    // 프레임 버퍼를 해제하는 함수
     void ReleaseFrameBuffer()
     {
         if (FrameBuffer)
@@ -214,17 +176,55 @@ public:
         }
     }
 
-    // Ͷ ¸ ϴ Լ
+    // 스왑 체인과 같은 크기의 깊이 버퍼를 생성하는 함수
+    void CreateDepthBuffer()
+    {
+        D3D11_TEXTURE2D_DESC depthbufferdesc = {};
+        depthbufferdesc.Width = (UINT)ViewportInfo.Width;
+        depthbufferdesc.Height = (UINT)ViewportInfo.Height;
+        depthbufferdesc.MipLevels = 1;
+        depthbufferdesc.ArraySize = 1;
+        depthbufferdesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT; // 깊이 24비트 + 스텐실 8비트
+        depthbufferdesc.SampleDesc.Count = 1;
+        depthbufferdesc.Usage = D3D11_USAGE_DEFAULT;
+        depthbufferdesc.BindFlags = D3D11_BIND_DEPTH_STENCIL;
+
+        Device->CreateTexture2D(&depthbufferdesc, nullptr, &DepthBuffer);
+        Device->CreateDepthStencilView(DepthBuffer, nullptr, &DepthBufferDSV);
+    }
+
+    // 깊이 버퍼를 해제하는 함수
+    void ReleaseDepthBuffer()
+    {
+        if (DepthBufferDSV)
+        {
+            DepthBufferDSV->Release();
+            DepthBufferDSV = nullptr;
+        }
+
+        if (DepthBuffer)
+        {
+            DepthBuffer->Release();
+            DepthBuffer = nullptr;
+        }
+    }
+
+    // 래스터라이저 상태를 생성하는 함수
     void CreateRasterizerState()
     {
         D3D11_RASTERIZER_DESC rasterizerdesc = {};
-        rasterizerdesc.FillMode = D3D11_FILL_SOLID; // ä 
-        rasterizerdesc.CullMode = D3D11_CULL_BACK; //  ̽ ø
+        rasterizerdesc.FillMode = D3D11_FILL_SOLID; // 채우기 모드
+        rasterizerdesc.CullMode = D3D11_CULL_BACK; // 백 페이스 컬링
 
         Device->CreateRasterizerState(&rasterizerdesc, &RasterizerState);
+
+        // 구 메시는 바깥 면이 반시계 방향이라 백 페이스 컬링으로는 먼 쪽 반구의 안쪽 면이 그려진다
+        // 2D에서는 가까운 반구가 z < 0이라 어차피 잘리지만, 3D에서는 앞면을 컬링해야 가까운 반구가 보인다
+        rasterizerdesc.CullMode = D3D11_CULL_FRONT;
+        Device->CreateRasterizerState(&rasterizerdesc, &RasterizerStateCullFront);
     }
 
-    // Ͷ ¸ ϴ Լ
+    // 래스터라이저 상태를 해제하는 함수
     void ReleaseRasterizerState()
     {
         if (RasterizerState)
@@ -232,27 +232,34 @@ public:
             RasterizerState->Release();
             RasterizerState = nullptr;
         }
+
+        if (RasterizerStateCullFront)
+        {
+            RasterizerStateCullFront->Release();
+            RasterizerStateCullFront = nullptr;
+        }
     }
 
-    //    ҽ ϴ Լ
+    // 렌더러에 사용된 모든 리소스를 해제하는 함수
     void Release()
     {
-        RasterizerState->Release();
+        ReleaseRasterizerState();
 
-        //  Ÿ ʱȭ
+        // 렌더 타겟을 초기화
         DeviceContext->OMSetRenderTargets(0, nullptr, nullptr);
 
+        ReleaseDepthBuffer();
         ReleaseFrameBuffer();
         ReleaseDeviceAndSwapChain();
     }
 
-    //  ü  ۿ Ʈ ۸ üϿ ȭ鿡 
+    // 스왑 체인의 백 버퍼와 프론트 버퍼를 교체하여 화면에 출력
     void SwapBuffer()
     {
-        SwapChain->Present(1, 0); // 1: VSync Ȱȭ
+        SwapChain->Present(1, 0); // 1: VSync 활성화
     }
 
-	// ̴ 
+	// 셰이더 생성
     void CreateShader()
     {
         ID3DBlob* vertexshaderCSO;
@@ -280,7 +287,7 @@ public:
         pixelshaderCSO->Release();
     }
 
-	// ̴ 
+	// 셰이더 해제
     void ReleaseShader()
     {
         if (SimpleInputLayout)
@@ -305,13 +312,14 @@ public:
     void Prepare()
     {
         DeviceContext->ClearRenderTargetView(FrameBufferRTV, ClearColor);
+        DeviceContext->ClearDepthStencilView(DepthBufferDSV, D3D11_CLEAR_DEPTH, 1.0f, 0);
 
         DeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
         DeviceContext->RSSetViewports(1, &ViewportInfo);
         DeviceContext->RSSetState(RasterizerState);
 
-        DeviceContext->OMSetRenderTargets(1, &FrameBufferRTV, nullptr);
+        DeviceContext->OMSetRenderTargets(1, &FrameBufferRTV, DepthBufferDSV);
         DeviceContext->OMSetBlendState(nullptr, nullptr, 0xffffffff);
     }
 
@@ -320,7 +328,7 @@ public:
         DeviceContext->VSSetShader(SimpleVertexShader, nullptr, 0);
         DeviceContext->PSSetShader(SimplePixelShader, nullptr, 0);
         DeviceContext->IASetInputLayout(SimpleInputLayout);
-        // ؽ ̴  ۸ մϴ.
+        // 버텍스 쉐이더에 상수 버퍼를 설정합니다.
         if (ConstantBuffer)
         {
             DeviceContext->VSSetConstantBuffers(0, 1, &ConstantBuffer);
@@ -368,7 +376,7 @@ public:
         Device->CreateBuffer(&constantbufferdesc, nullptr, &ConstantBuffer);
     }
 
-    void UpdateConstant(FVector offset, float scale = 1.0f) //  Ʈ
+    void UpdateConstant(FVector offset, float scale = 1.0f) // 상수버퍼 업데이트
     {
         if (ConstantBuffer)
         {
@@ -377,10 +385,27 @@ public:
             FConstants* data = (FConstants*)mapped.pData;
             data->Offset = offset;
             data->Scale = scale;
+            memcpy(data->ViewProjection, ViewProjection, sizeof(ViewProjection));
             DeviceContext->Unmap(ConstantBuffer, 0);
         }
     }
 
+    // 3D 카메라의 뷰-투영 행렬을 쓴다 (Prepare 뒤에 호출)
+    void SetViewProjection(const float viewProjection[4][4])
+    {
+        memcpy(ViewProjection, viewProjection, sizeof(ViewProjection));
+        DeviceContext->RSSetState(RasterizerStateCullFront);
+    }
+
+    // 뷰-투영 행렬을 단위 행렬로 (2D 모드, Prepare 뒤에 호출)
+    void ResetViewProjection()
+    {
+        for (int row = 0; row < 4; row++)
+            for (int col = 0; col < 4; col++)
+                ViewProjection[row][col] = row == col ? 1.0f : 0.0f;
+        DeviceContext->RSSetState(RasterizerState);
+    }
+
     void ReleaseConstantBuffer()
     {
         if (ConstantBuffer)
@@ -390,218 +415,172 @@ public:
         }
     }
 
-	void DrawSphere(const FVector& center, float scale) //  ׸
+	void DrawSphere(const FVector& center, float scale) // 구 그리기
     {
         UpdateConstant(center, scale);
         UINT offset = 0;
         DeviceContext->IASetVertexBuffers(0, 1, &VertexBufferSphere, &Stride, &offset);
         DeviceContext->Draw(NumVerticesSphere, 0);
     }
-};
 
-class UPrimitive
-{
-public:
-    virtual void Update(float t) = 0;
-    virtual void Render(URenderer& renderer) = 0;
-    virtual bool Collision(UPrimitive* other) = 0;
-    virtual void Translate(const FVector& v) = 0;
+    // 월드 좌표 선분 목록 그리기
+    void DrawLines(ID3D11Buffer* vertexBuffer, UINT numVertices)
+    {
+        if (!vertexBuffer || numVertices == 0) return;
+
+        UpdateConstant(FVector(0.0f), 1.0f);
+        DeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_LINELIST);
+        RenderPrimitive(vertexBuffer, numVertices);
+        DeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    }
 };
 
-class UBall : public UPrimitive
-{
-public:
-    //  
-    FVector Location; //  ġ
-	FVector Velocity; //  ӵ
-	float Radius; // 
-	float Mass; // 
-	static int TotalNumBalls; //    
+// 물리 프레임을 여러 코어로 나눠 처리하는 잡 시스템
+FJobSystem JobSystem;
 
-    // :     
-    UBall(FVector loc, FVector vel, float radius)
-        : Location(loc), Velocity(vel), Radius(radius)
-    {
-        //  ^2 
-        Mass = Radius * Radius;
-        TotalNumBalls++;
-    }
+// 공 시뮬레이션 (물리 전체, 창이나 D3D와 무관)
+// 물리 스레드가 시작한 뒤로는 SimThread만 만지고, UI는 설정과 스냅숏으로만 주고받는다
+FBallSimulation Simulation(JobSystem);
+FSimulationThread SimThread(Simulation, JobSystem);
+FSimulationSettings Settings; // UI가 고치는 설정 (프레임마다 SimThread.UpdateSettings로 넘긴다)
 
-    // Ҹ:  
-    virtual ~UBall()
+// 마우스로 공 고르기와 폭발 (스냅숏으로 만든 UI 쪽 트리로 고른다)
+FDynamicAabbTree PickTree;
+int HoveredBall = -1; // 스냅숏 안의 인덱스
+float ExplosionRadius = 0.3f;
+float ExplosionSpeed = 3.0f;
+
+// 장애물과 용기 외곽선을 정점 버퍼로 다시 만든다 (장애물이 없으면 버퍼도 없음)
+// 2D 모드에서는 z를 0으로 눌러서, 깊이 범위 밖인 앞뒤 면 모서리도 화면에 남게 한다
+void RebuildObstacleOutline(URenderer& renderer, const FBallSnapshot& snapshot)
+{
+    if (renderer.VertexBufferObstacles)
     {
-        TotalNumBalls--;
+        renderer.ReleaseVertexBuffer(renderer.VertexBufferObstacles);
+        renderer.VertexBufferObstacles = nullptr;
     }
 
-    // A:   Ʈ
-    void Update(float dt) override
-    {
-        // ߷ (Y Ʒ )
-        if (EnableGravity)
-        {
-            Velocity.y += GravityAcceleration * dt;
-        }
+    const std::vector<FVector>& lines = snapshot.ObstacleOutline;
+    renderer.NumVerticesObstacles = (UINT)lines.size();
+    if (lines.empty()) return;
 
-        // ġ = ġ + (ӵ * ð)
-        Location += Velocity * dt;
-		//ȭ  浹 ó
-        const float left = -1.0f + Radius;
-        const float right = 1.0f - Radius;
-        const float top = -1.0f + Radius;
-        const float bottom = 1.0f - Radius;
+    std::vector<FVertexSimple> vertices(lines.size());
+    for (size_t k = 0; k < lines.size(); k++)
+        vertices[k] = { lines[k].x, lines[k].y, snapshot.Enable3D ? lines[k].z : 0.0f, 0.9f, 0.75f, 0.3f, 1.0f };
+    renderer.VertexBufferObstacles = renderer.CreateVertexBuffer(vertices.data(), (UINT)(vertices.size() * sizeof(FVertexSimple)));
+}
 
-		// 迡  ġ   ӵ  ( ս )
-        if (Location.x <= left) { Location.x = left;   Velocity.x = -Velocity.x * 0.8f; }
-        if (Location.x >= right) { Location.x = right;  Velocity.x = -Velocity.x * 0.8f; }
-        if (Location.y <= top) { Location.y = top;    Velocity.y = -Velocity.y * 0.8f; }
-        if (Location.y >= bottom) { Location.y = bottom; Velocity.y = -Velocity.y * 0.8f; }
+// 3D 모드에서 상자 중심을 바라보며 도는 카메라 (D3D 왼손 좌표계, yaw = pitch = 0이면 2D 화면처럼 -z에서 +z를 본다)
+struct FOrbitCamera
+{
+    float Yaw = 0.6f;      // 라디안
+    float Pitch = 0.45f;
+    float Distance = 3.6f;
+    float FovY = 1.0f;     // 세로 시야각 (라디안)
+    float NearZ = 0.1f;
+    float FarZ = 20.0f;
+
+    FVector GetEye() const
+    {
+        return FVector(Distance * cosf(Pitch) * sinf(Yaw), Distance * sinf(Pitch), -Distance * cosf(Pitch) * cosf(Yaw));
     }
 
-    // B:  (Renderer  ۿ )
-    void Render(URenderer& renderer) override
+    // 카메라의 앞, 오른쪽, 위 방향
+    void GetBasis(FVector& outForward, FVector& outRight, FVector& outUp) const
     {
-        // 1. GPU   ġ ˸
-        renderer.UpdateConstant(Location);
-        // 2. غ ؽ ۸ ׸
-        renderer.DrawSphere(Location, Radius);
+        outForward = (FVector(0.0f) - GetEye()).GetSafeNormal();
+        outRight = FVector(0.0f, 1.0f, 0.0f).Cross(outForward).GetSafeNormal();
+        outUp = outForward.Cross(outRight);
     }
 
-    // C:  vs  浹   
-    bool Collision(UPrimitive* other) override
+    // 뷰 행렬과 원근 투영 행렬(깊이 0 ~ 1)을 곱한 월드 -> 클립 공간 행렬
+    void BuildViewProjection(float aspect, float out[4][4]) const
     {
-		// ٸ Ƽ갡  Ȯ
-        UBall* otherBall = dynamic_cast<UBall*>(other);
-        if (!otherBall || this == otherBall) return false;
-
-		// 浹 
-        FVector toOther = otherBall->Location - Location;
-
-		//Ÿ     
-        float distanceSq = toOther.SizeSquared();
-        float sumRadius = Radius + otherBall->Radius;
-
-		// 浹 
-        if (distanceSq > sumRadius * sumRadius || distanceSq < 1e-6f)
-            return false;
-
-		// 浹
-        float distance = sqrtf(distanceSq);
-        FVector normal = toOther.GetSafeNormal();
-
-        // penetration ġ 
-        float penetration = sumRadius - distance;
-        if (penetration > 0.001f)
+        FVector forward, right, up;
+        GetBasis(forward, right, up);
+        const FVector eye = GetEye();
+        const float view[4][4] =
         {
-            float totalMass = Mass + otherBall->Mass;
-
-			//      ġ 
-            float ratioA = otherBall->Mass / totalMass;
-            float ratioB = Mass / totalMass;
-
-            FVector correction = normal * penetration * 0.8f;
-            Location -= correction * ratioA;
-            otherBall->Location += correction * ratioB;
-        }
-
-        // impulse (ƨ)
-        FVector relativeVelocity = otherBall->Velocity - Velocity;
-        float velAlongNormal = relativeVelocity.Dot(normal);
+            { right.x, up.x, forward.x, 0.0f },
+            { right.y, up.y, forward.y, 0.0f },
+            { right.z, up.z, forward.z, 0.0f },
+            { -right.Dot(eye), -up.Dot(eye), -forward.Dot(eye), 1.0f },
+        };
 
-		// 浹  ƨ ó
-        if (velAlongNormal < -0.01f)
+        const float yScale = 1.0f / tanf(FovY * 0.5f);
+        const float xScale = yScale / aspect;
+        const float depthScale = FarZ / (FarZ - NearZ);
+        const float projection[4][4] =
         {
-			const float restitution = 0.6f; // ݹ  (0~1  )
-
-            float j = -(1.0f + restitution) * velAlongNormal;
-            j /= (1.0f / Mass + 1.0f / otherBall->Mass);
+            { xScale, 0.0f, 0.0f, 0.0f },
+            { 0.0f, yScale, 0.0f, 0.0f },
+            { 0.0f, 0.0f, depthScale, 1.0f },
+            { 0.0f, 0.0f, -NearZ * depthScale, 0.0f },
+        };
 
-            FVector impulse = normal * j;
-            Velocity -= impulse * (1.0f / Mass);
-            otherBall->Velocity += impulse * (1.0f / otherBall->Mass);
+        for (int row = 0; row < 4; row++)
+        {
+            for (int col = 0; col < 4; col++)
+            {
+                out[row][col] = 0.0f;
+                for (int k = 0; k < 4; k++)
+                    out[row][col] += view[row][k] * projection[k][col];
+            }
         }
-
-        return true;
     }
 
-    // ġ ̵
-    void Translate(const FVector& v) override
+    // 창 좌표를 지나는 광선의 방향 (시작점은 GetEye)
+    FVector GetRayDirection(float screenX, float screenY, float width, float height) const
     {
-        Location = v;
+        FVector forward, right, up;
+        GetBasis(forward, right, up);
+        const float tanHalfFov = tanf(FovY * 0.5f);
+        const float ndcX = screenX / width * 2.0f - 1.0f;
+        const float ndcY = 1.0f - screenY / height * 2.0f;
+        return (forward + right * (ndcX * tanHalfFov * width / height) + up * (ndcY * tanHalfFov)).GetSafeNormal();
     }
 };
 
-//   ʱȭ
-int UBall::TotalNumBalls = 0;
+FOrbitCamera Camera;
 
-UPrimitive** PrimitiveList = nullptr;
-int CurrentBallCount = 0;
-int DesiredBallCount = 0;
 
-UBall* CreateRandomBall()
+// 창 좌표를 월드 좌표로 ([-1, 1] 정사각형이 창 전체에 그려진다)
+FVector ScreenToWorld(float screenX, float screenY, float width, float height)
 {
-    FVector randomPos(
-        -0.85f + (rand() % 1700) / 1000.0f,   // -0.85 ~ 0.85
-        -0.85f + (rand() % 1700) / 1000.0f,
-        0.0f
-    );
-
-    FVector randomVel(
-        (rand() % 401 - 200) / 300.0f,    // -0.666 ~ +0.666 
-        (rand() % 401 - 200) / 300.0f,
-        0.0f
-    );
-
-    float randomRadius = 0.035f + (rand() % 31) / 100.0f;  // 0.025 ~ 0.055
-
-    return new UBall(randomPos, randomVel, randomRadius);
+    return FVector(screenX / width * 2.0f - 1.0f, 1.0f - screenY / height * 2.0f, 0.0f);
 }
 
-void UpdateBallCount()
+// 마우스 아래의 공을 고르고, 왼쪽 버튼을 누르면 그 자리에서 폭발시킨다
+// 3D 모드에서는 카메라에서 마우스 방향으로 쏜 광선에 처음 맞은 공을 고르고, 맞은 점에서 폭발시킨다
+void ProcessMouse(const ImGuiIO& io, const FBallSnapshot& snapshot)
 {
-    if (DesiredBallCount == CurrentBallCount) return;
+    HoveredBall = -1;
+    if (io.WantCaptureMouse || snapshot.Count == 0) return;
 
-    if (DesiredBallCount > CurrentBallCount)
+    PickTree.Update(snapshot.PosX.data(), snapshot.PosY.data(), snapshot.PosZ.data(), snapshot.Radius.data(), snapshot.Count);
+    FVector target;
+    if (snapshot.Enable3D)
     {
-        // 1. ӽ 迭   (غ Ϸ  PrimitiveList ǵ帮 )
-        UPrimitive** newList = new UPrimitive * [DesiredBallCount];
-
-        //   
-        for (int i = 0; i < CurrentBallCount; i++)
-            newList[i] = PrimitiveList[i];
-
-        //   ߰
-        for (int i = CurrentBallCount; i < DesiredBallCount; i++)
-            newList[i] = CreateRandomBall();
-
-        // 2. ü ۾
-        UPrimitive** oldList = PrimitiveList;
-        PrimitiveList = newList; // ⼭ ͸  ü
-
-        if (oldList != nullptr) delete[] oldList; //  迭 
-
-        CurrentBallCount = DesiredBallCount;
+        FDynamicAabbTree::FRayHit hit;
+        const FVector direction = Camera.GetRayDirection(io.MousePos.x, io.MousePos.y, io.DisplaySize.x, io.DisplaySize.y);
+        if (!PickTree.RayCast(Camera.GetEye(), direction, Camera.FarZ, hit)) return;
+        HoveredBall = hit.Ball;
+        target = hit.Point;
     }
-    else if (DesiredBallCount < CurrentBallCount)
+    else
     {
-        //  ̱
-        int toRemove = CurrentBallCount - DesiredBallCount;
-        for (int k = 0; k < toRemove; k++)
-        {
-            if (CurrentBallCount <= 0) break;
-            int removeIdx = rand() % CurrentBallCount;
-
-            delete PrimitiveList[removeIdx];
-            PrimitiveList[removeIdx] = PrimitiveList[CurrentBallCount - 1];
-            PrimitiveList[CurrentBallCount - 1] = nullptr;
-            CurrentBallCount--;
-        }
+        target = ScreenToWorld(io.MousePos.x, io.MousePos.y, io.DisplaySize.x, io.DisplaySize.y);
+        HoveredBall = PickTree.PickPoint(target);
     }
-}
 
+    // 폭발은 명령으로 보내 물리 스레드가 다음 스텝 전에 적용한다
+    if (ImGui::IsMouseClicked(0))
+        SimThread.Explode(target, ExplosionRadius, ExplosionSpeed);
+}
 
 extern LRESULT ImGui_ImplWin32_WndProcHandler(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
-//  ޽ ó Լ
+// 각종 메시지를 처리할 함수
 LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 {
 	if (ImGui_ImplWin32_WndProcHandler(hWnd, message, wParam, lParam))
@@ -623,19 +602,19 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nShowCmd)
 {
-    //  Ŭ ̸
+    // 윈도우 클래스 이름
     WCHAR WindowClass[] = L"JungleWindowClass";
 
-    //  ŸƲٿ ǥõ ̸
+    // 윈도우 타이틀바에 표시될 이름
     WCHAR Title[] = L"Game Tech Lab";
 
-    //  ޽ ó Լ WndProc Լ ͸ WindowClass ü ִ´.
+    // 각종 메시지를 처리할 함수인 WndProc의 함수 포인터를 WindowClass 구조체에 넣는다.
     WNDCLASSW wndclass = { 0, WndProc, 0, 0, 0, 0, 0, 0, 0, WindowClass };
 
-    //  Ŭ 
+    // 윈도우 클래스 등록
     RegisterClassW(&wndclass);
 
-    // 1024 x 1024 ũ⿡  
+    // 1024 x 1024 크기에 윈도우 생성
     HWND hWnd = CreateWindowExW(0, WindowClass, Title, WS_POPUP | WS_VISIBLE | WS_OVERLAPPEDWINDOW,
         CW_USEDEFAULT, CW_USEDEFAULT, 1024, 1024,
         nullptr, nullptr, hInstance, nullptr);
@@ -643,17 +622,17 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     bool bIsExit = false;
 
 
-    // Renderer Class մϴ.
+    // Renderer Class를 생성합니다.
     URenderer	renderer;
 
-    // D3D11 ϴ Լ ȣմϴ.
+    // D3D11 생성하는 함수를 호출합니다.
     renderer.Create(hWnd);
     renderer.CreateShader();
 
-    // ⿡  Լ ߰մϴ.	
+    // 여기에 생성 함수를 추가합니다.	
     renderer.CreateConstantBuffer();
 
-	// ImGui ʱȭ
+	// ImGui 초기화
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
     ImGuiIO& io = ImGui::GetIO();
@@ -673,38 +652,42 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 
     renderer.NumVerticesSphere = numVerticesSphere;
 
-    //     offset  Main  ٷ տ  ϼ.	
-    FVector	offset(0.0f); // Ű Է¿  ӵ 
-	FVector	velocity(0.0f); // ӵ
+    // 도형의 움직임 정도를 담을 offset 변수를 Main 루프 바로 앞에 정의 하세요.	
+    FVector	offset(0.0f); // 키보드 입력에 따른 속도 
+	FVector	velocity(0.0f); // 속도
 
-    // FPS   
+    // FPS 제한을 위한 설정
     const int targetFPS = 30;
-    const double targetFrameTime = 1000.0 / targetFPS; //   ǥ ð (и )
+    const double targetFrameTime = 1000.0 / targetFPS; // 한 프레임의 목표 시간 (밀리초 단위)
 
-    //  Ÿ̸ ʱȭ
+    // 고성능 타이머 초기화
     LARGE_INTEGER frequency;
     QueryPerformanceFrequency(&frequency);
 
     LARGE_INTEGER startTime, endTime;
     double elapsedTime = 0.0;
 
+    // 물리 스레드 시작 (잡 시스템도 물리 스레드가 시작해서 쓴다)
+    SimThread.Start(Settings);
+    int obstacleVersion = -1; // 정점 버퍼로 만든 외곽선의 버전
+
     while (bIsExit == false)
     {
-        // Main Loop (Quit Message   Ʒ Loop  ϰ )
+        // Main Loop (Quit Message가 들어오기 전까지 아래 Loop를 무한히 실행하게 됨)
         while (bIsExit == false)
         {
-            //   ð 
+            // 루프 시작 시간 기록
             QueryPerformanceCounter(&startTime);
 
             MSG msg;
 
-            // ó ޽  ̻   
+            // 처리할 메시지가 더 이상 없을때 까지 수행
             while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
             {
-                // Ű Է ޽ 
+                // 키 입력 메시지를 번역
                 TranslateMessage(&msg);
 
-                // ޽   ν , ޽   WndProc  ޵
+                // 메시지를 적절한 윈도우 프로시저에 전달, 메시지가 위에서 등록한 WndProc 으로 전달됨
                 DispatchMessage(&msg);
 
                 if (msg.message == WM_QUIT)
@@ -714,97 +697,136 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
                 }
             }
             ////////////////////////////////////////////
-            // Ź Ǵ ڵ带 ⿡ ߰մϴ.
+            // 매번 실행되는 코드를 여기에 추가합니다.
+
+			//1. 바뀐 설정을 물리 스레드로 보낸다 (공 수, 중력 등)
+            SimThread.UpdateSettings(Settings);
 
-			//1.   Ʈ
-            UpdateBallCount();
+			//2. 물리 스레드가 낸 가장 최근 스냅숏을 가져온다 (물리는 이 스레드와 상관없이 고정 간격으로 진행)
+            SimThread.AcquireSnapshot();
+            const FBallSnapshot& snapshot = SimThread.GetSnapshot();
+            if (snapshot.ObstacleVersion != obstacleVersion)
+            {
+                RebuildObstacleOutline(renderer, snapshot);
+                obstacleVersion = snapshot.ObstacleVersion;
+            }
 
-			//2. delta time 
-            double dt = elapsedTime / 1000.0;
+			 // 3. 렌더링
+             renderer.Prepare();       // 화면 지우기
+             renderer.PrepareShader(); // 쉐이더 장착
 
-			//3.  Ʈ
-             for (int i = 0; i < CurrentBallCount; i++)
+             // 3D 모드는 궤도 카메라로 원근 투영, 2D 모드는 단위 행렬
+             if (snapshot.Enable3D)
              {
-                 PrimitiveList[i]->Update(dt);
+                 float viewProjection[4][4];
+                 Camera.BuildViewProjection(renderer.ViewportInfo.Width / renderer.ViewportInfo.Height, viewProjection);
+                 renderer.SetViewProjection(viewProjection);
              }
-			 //4. 浹 ó
-             const int collisionPasses = 2;
-             for (int pass = 0; pass < collisionPasses; pass++)
+             else
              {
-                 for (int i = 0; i < CurrentBallCount; i++)
-                 {
-                     for (int j = i + 1; j < CurrentBallCount; j++)
-                     {
-                         if (PrimitiveList[i] && PrimitiveList[j])
-                         {
-                             PrimitiveList[i]->Collision(PrimitiveList[j]);
-                         }
-                     }
-                 }
+                 renderer.ResetViewProjection();
              }
-			 // 5. 
-             renderer.Prepare();       // ȭ 
-             renderer.PrepareShader(); // ̴ 
-
-             //   ׸
-             for (int i = 0; i < CurrentBallCount; i++)
-                 PrimitiveList[i]->Render(renderer);
-            // offset  ۷ Ʈ մϴ.
+
+             // 모든 공 그리기 (스냅숏의 직전 스텝과 마지막 스텝 사이를 낸 뒤 흐른 시간만큼 보간)
+             const float alpha = snapshot.GetAlpha(FSimulationThread::Now());
+             for (int i = 0; i < snapshot.Count; i++)
+                 renderer.DrawSphere(snapshot.GetInterpolatedLocation(i, alpha), snapshot.Radius[i]);
+             renderer.DrawLines(renderer.VertexBufferObstacles, renderer.NumVerticesObstacles);
+            // offset을 상수 버퍼로 업데이트 합니다.
             renderer.UpdateConstant(offset);
 
             ImGui_ImplDX11_NewFrame();
             ImGui_ImplWin32_NewFrame();
             ImGui::NewFrame();
 
-            //  ImGui UI Ʈ ߰ ImGui::NewFrame() ImGui::Render()  ⿡ ġմϴ.
+            ProcessMouse(io, snapshot);
+
+            // 이후 ImGui UI 컨트롤 추가는 ImGui::NewFrame()과 ImGui::Render() 사이인 여기에 위치합니다.
             ImGui::Begin("Jungle Property Window");
             ImGui::Text("Hello Jungle World!");
             if (ImGui::Button("Quit this app"))
             {
-                //  쿡 Quit ޽ ޽ ť 
+                // 현재 윈도우에 Quit 메시지를 메시지 큐로 보냄
                 PostMessage(hWnd, WM_QUIT, 0, 0);
             }
-            // Hello Jungle World Ʒ CheckBox bBoundBallToScreen  մϴ.
-            ImGui::InputInt("Number of Balls", &DesiredBallCount);
-			ImGui::Checkbox("Gravity", &EnableGravity);
+            // Hello Jungle World 아래에 CheckBox와 bBoundBallToScreen 변수를 연결합니다.
+            ImGui::InputInt("Number of Balls", &Settings.BallCount);
+			ImGui::Checkbox("Gravity", &Settings.EnableGravity);
+            ImGui::Checkbox("3D", &Settings.Enable3D); // 공을 지우고 새 모드로 다시 뿌린다
+            if (Settings.Enable3D)
+            {
+                ImGui::SliderAngle("Camera Yaw", &Camera.Yaw, -180.0f, 180.0f);
+                ImGui::SliderAngle("Camera Pitch", &Camera.Pitch, -85.0f, 85.0f);
+                ImGui::SliderFloat("Camera Distance", &Camera.Distance, 1.5f, 10.0f);
+            }
+            ImGui::Combo("Obstacles", &Settings.ObstacleLayout, "None\0Pegs\0Funnel\0"); // 공을 지우고 장애물을 피해 다시 뿌린다
+            ImGui::Combo("Container", &Settings.ContainerShape, "Box\0Circle\0Star\0Mask\0"); // 거리장을 다시 굽고 공은 용기 안에 다시 뿌린다
+            ImGui::Combo("Broadphase", &Settings.BroadPhaseType, "Spatial Hash\0Sweep and Prune\0Brute Force\0");
+            ImGui::Combo("Solver", &Settings.SolverType, "Impulse\0XPBD (Gauss-Seidel)\0XPBD (Jacobi)\0"); // XPBD는 서브스텝마다 위치 제약을 고정 횟수 반복
+            ImGui::Checkbox("CCD", &Settings.EnableCcd);
+            ImGui::Checkbox("Sleeping", &Settings.EnableSleeping);
+            ImGui::Checkbox("Adaptive Substeps", &Settings.EnableAdaptiveSubsteps); // 가장 빠른 공과 가장 작은 반지름으로 서브스텝 수를 고른다
+            if (!Settings.EnableAdaptiveSubsteps && Settings.SolverType == Solver_Impulse)
+                ImGui::SliderInt("Collision Passes", &Settings.CollisionPasses, 1, 4);
+            ImGui::SliderInt("Reorder Interval", &Settings.ReorderInterval, 0, 240); // 0이면 Morton 재배치 끔
+
+            const FSimulationStats& stats = snapshot.Stats;
+            ImGui::Text("SIMD: %s", GetSimdLevelName(ActiveSimdLevel()));
+            ImGui::Text("Physics: %.0f Hz  Steps: %d  Substeps: %d  Step: %.2f ms", 1.0f / stats.StepTime, stats.LastSteps, stats.LastSubsteps, stats.StepMs);
+            ImGui::Text("Awake: %d / %d", stats.NumAwake, snapshot.Count);
+            ImGui::Text("Spawn Overlaps: %d", stats.SpawnOverlaps);
+            ImGui::Text("Fast Balls: %d  TOI Impacts: %d", stats.NumFastBalls, stats.NumImpacts);
+            ImGui::Text("Obstacles: %d  BVH Nodes: %d  Candidates: %d  Contacts: %d", stats.NumObstacles,
+                stats.NumBvhNodes, stats.NumObstacleCandidates, stats.NumObstacleContacts);
+            ImGui::Text("Pairs: %d  Contacts: %d  Batches: %d", stats.NumPairs, stats.NumContacts, stats.NumBatches);
+            if (Settings.BroadPhaseType == BroadPhase_SweepAndPrune)
+                ImGui::Text("SAP Swaps: %d  Added: %d  Removed: %d", stats.SapSwaps, stats.SapAdded, stats.SapRemoved);
+            if (HoveredBall >= 0)
+                ImGui::Text("Hovered Ball: #%u  Radius: %.3f", snapshot.Ids[HoveredBall], snapshot.Radius[HoveredBall]);
+            else
+                ImGui::Text("Hovered Ball: -");
+            ImGui::SliderFloat("Explosion Radius", &ExplosionRadius, 0.05f, 1.0f);
+            ImGui::Text("Tree Height: %d  Reinserted: %d", stats.TreeHeight, stats.NumReinserted);
+            if (Settings.SolverType == Solver_Impulse)
+                ImGui::Text("Solver Iterations: %d  Warm Started: %d", stats.SolverIterations, stats.NumWarmStarted);
+            else
+                ImGui::Text("Constraints: %d  Max Error: %.5f", stats.NumConstraints, stats.MaxError);
+            // 스레드 수 제한 (0이면 모든 코어), 바뀌면 물리 스레드가 잡 시스템을 다시 시작
+            ImGui::SliderInt("Thread Cap", &Settings.ThreadCap, 0, (int)std::thread::hardware_concurrency());
+            ImGui::Checkbox("Deterministic Jobs", &Settings.DeterministicJobs);
+            ImGui::Text("Threads: %d  Dropped Commands: %d", stats.NumThreads, stats.NumDroppedCommands);
             ImGui::End();
 
             ImGui::Render();
             ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
 
-            //  ׷ ۸ ȯ
+            // 다 그렸으면 버퍼를 교환
             renderer.SwapBuffer();
-            // ⿡ ߰մϴ.		
+            // 여기에 추가합니다.		
             do
             {
                 Sleep(0);
 
-                //   ð 
+                // 루프 종료 시간 기록
                 QueryPerformanceCounter(&endTime);
 
-                //   ҿ ð  (и  ȯ)
+                // 한 프레임이 소요된 시간 계산 (밀리초 단위로 변환)
                 elapsedTime = (endTime.QuadPart - startTime.QuadPart) * 1000.0 / frequency.QuadPart;
 
             } while (elapsedTime < targetFrameTime);
             ////////////////////////////////////////////
         }
 
-        // Ҹϴ ڵ带 ⿡ ߰մϴ.
-        //  Ҹ  ̴ Ҹ Ű Լ ȣմϴ.
-		if (PrimitiveList) //  Ҹ
-        {
-            for (int i = 0; i < CurrentBallCount; i++)
-            {
-                delete PrimitiveList[i];
-                PrimitiveList[i] = nullptr;
-            }
-            delete[] PrimitiveList;
-            PrimitiveList = nullptr;
-        }
+        // 소멸하는 코드를 여기에 추가합니다.
+        // 렌더러 소멸 직전에 쉐이더를 소멸 시키는 함수를 호출합니다.
+        SimThread.Stop(); // 물리 스레드가 잡 시스템도 멈춘다
+		Simulation.World.Clear(); // 원 소멸
         ImGui_ImplDX11_Shutdown();
         ImGui_ImplWin32_Shutdown();
         ImGui::DestroyContext();
         renderer.ReleaseVertexBuffer(renderer.VertexBufferSphere);
+        if (renderer.VertexBufferObstacles)
+            renderer.ReleaseVertexBuffer(renderer.VertexBufferObstacles);
         renderer.ReleaseConstantBuffer();
         renderer.ReleaseShader();
         renderer.Release();